@@ -11,8 +11,8 @@
 #include <stdlib.h>
 
 #include "game_ext.h"
+#include "game_fast.h"
 #include "game_private.h"
-#include "queue.h"
 
 /* ************************************************************************** */
 /*                                INTERNAL                                    */
@@ -30,20 +30,11 @@ static void _update_lighted_flags(game g, uint i, uint j) {
   /* update square (i,j) */
   SQUARE(g, i, j) |= F_LIGHTED;
 
-  uint startdir = UP;
-  uint enddir = RIGHT;
-  uint dim = MAX(g->nb_rows, g->nb_cols);
-
   // update lighted flags in all directions
-  for (uint dir = startdir; dir <= enddir; dir++) {
-    int ii = i;
-    int jj = j;
-    for (uint k = 1; k < dim; k++) {
-      bool cont = _next(g, &ii, &jj, dir);  // update next coord (ii,jj)
-      if (!cont) break;
-      if (STATE(g, ii, jj) & S_BLACK) break;
-      SQUARE(g, ii, jj) |= F_LIGHTED;
-    }
+  uint cells[MAX(g->nb_rows, g->nb_cols)];
+  for (uint dir = UP; dir <= RIGHT; dir++) {
+    uint n = _ray(g, i, j, dir, cells);
+    for (uint k = 0; k < n; k++) g->squares[cells[k]] |= F_LIGHTED;
   }
 }
 
@@ -56,21 +47,12 @@ static bool _check_lightbulb_error(cgame g, uint i, uint j) {
   // square s = STATE(g, i, j);
   // assert(s == S_LIGHTBULB);
 
-  // update lighted flags in all directions
-  direction dirs[] = {UP, DOWN, LEFT, RIGHT};
-  for (uint d = 0; d < 4; d++) {
-    direction dir = dirs[d];
-    int ii = i;
-    int jj = j;
-    uint dim = 0;
-    if (dir == UP || dir == DOWN) dim = g->nb_rows;
-    if (dir == LEFT || dir == RIGHT) dim = g->nb_cols;
-    for (uint k = 1; k < dim; k++) {
-      bool cont = _next(g, &ii, &jj, dir);  // update next coord (ii,jj)
-      if (!cont) break;
-      if (STATE(g, ii, jj) & S_BLACK) break;
-      if (STATE(g, ii, jj) == S_LIGHTBULB) return false;
-    }
+  // look for another light bulb in all directions
+  uint cells[MAX(g->nb_rows, g->nb_cols)];
+  for (uint dir = UP; dir <= RIGHT; dir++) {
+    uint n = _ray(g, i, j, dir, cells);
+    for (uint k = 0; k < n; k++)
+      if ((g->squares[cells[k]] & S_MASK) == S_LIGHTBULB) return false;
   }
 
   return true;
@@ -85,7 +67,7 @@ static bool _check_blackwall_error(cgame g, uint i, uint j) {
   square s = STATE(g, i, j);
   assert(s & S_BLACK);
   if (s == S_BLACKU) return true; /* no constraint for unumbered wall */
-  int expected = game_get_black_number(g, i, j);
+  int expected = game_fast_black_number(g, i, j);
   int nb_lightbulbs = _neigh_count(g, i, j, S_LIGHTBULB, S_MASK, false);
   int nb_blanks = _neigh_count(g, i, j, S_BLANK, A_MASK,
                                false);  // blank state, without lighted flag
@@ -118,6 +100,12 @@ game game_new_empty(void) {
 
 game game_copy(cgame g) {
   game gg = game_new_ext(g->nb_rows, g->nb_cols, g->squares, g->wrapping);
+  gg->edited = g->edited;
+  // the pending flags are computed in the copy: g is only read
+  gg->stale = g->stale;
+  for (uint l = 0; l < g->nb_touched; l++)
+    _flags_touch(gg, g->touched[l] / g->nb_cols, g->touched[l] % g->nb_cols);
+  _flags_resolve(gg);
   return gg;
 }
 
@@ -128,6 +116,8 @@ bool game_equal(cgame g1, cgame g2) {
 
   if (g1->nb_rows != g2->nb_rows) return false;
   if (g1->nb_cols != g2->nb_cols) return false;
+  _flags_resolve(g1);
+  _flags_resolve(g2);
 
   for (uint i = 0; i < g1->nb_rows; i++)
     for (uint j = 0; j < g1->nb_cols; j++) {
@@ -142,9 +132,11 @@ bool game_equal(cgame g1, cgame g2) {
 /* ************************************************************************** */
 
 void game_delete(game g) {
-  free(g->squares);
-  queue_free_full(g->undo_stack, free);
-  queue_free_full(g->redo_stack, free);
+  if (g->journal) _journal_close(g);
+  if (g->owned) free(g->squares);
+  free(g->history);
+  free(g->touched);
+  free(g->shown);
   free(g);
 }
 
@@ -154,7 +146,10 @@ void game_set_square(game g, uint i, uint j, square s) {
   assert(g);
   assert(i < g->nb_rows);
   assert(j < g->nb_cols);
+  _flags_resolve(g);  // the pending flags must not overwrite s
+  _own_squares(g);
   SQUARE(g, i, j) = s;
+  g->edited = true;
 }
 
 /* ************************************************************************** */
@@ -163,6 +158,7 @@ square game_get_square(cgame g, uint i, uint j) {
   assert(g);
   assert(i < g->nb_rows);
   assert(j < g->nb_cols);
+  _flags_resolve(g);
   return SQUARE(g, i, j);
 }
 
@@ -181,6 +177,7 @@ square game_get_flags(cgame g, uint i, uint j) {
   assert(g);
   assert(i < g->nb_rows);
   assert(j < g->nb_cols);
+  _flags_resolve(g);
   return FLAGS(g, i, j);
 }
 
@@ -188,6 +185,17 @@ square game_get_flags(cgame g, uint i, uint j) {
 
 void game_update_flags(game g) {
   assert(g);
+  // the flags are recomputed on their first query, so that a burst of
+  // updates costs a single one
+  g->stale = true;
+  g->nb_touched = 0;
+}
+
+/* ************************************************************************** */
+
+/* recompute all the flags from the states */
+static void _compute_flags(game g) {
+  _own_squares(g);
 
   // 0) reset all flags
   for (uint i = 0; i < g->nb_rows; i++)
@@ -201,15 +209,123 @@ void game_update_flags(game g) {
   // 2) update error flag
   for (uint i = 0; i < g->nb_rows; i++)
     for (uint j = 0; j < g->nb_cols; j++) {
-      if (game_is_lightbulb(g, i, j) && !_check_lightbulb_error(g, i, j))
+      if (game_fast_is_lightbulb(g, i, j) && !_check_lightbulb_error(g, i, j))
         SQUARE(g, i, j) |= F_ERROR;
-      if (game_is_black(g, i, j) && !_check_blackwall_error(g, i, j))
+      if (game_fast_is_black(g, i, j) && !_check_blackwall_error(g, i, j))
         SQUARE(g, i, j) |= F_ERROR;
     }
 }
 
 /* ************************************************************************** */
 
+/* recompute the flags of a single square from its neighborhood */
+static void _update_square_flags(game g, uint i, uint j) {
+  square s = STATE(g, i, j);
+  if (s & S_BLACK) {  // depends on the lighted flags around
+    SQUARE(g, i, j) = _check_blackwall_error(g, i, j) ? s : s | F_ERROR;
+    return;
+  }
+  bool seen = !_check_lightbulb_error(g, i, j);  // a light bulb in sight
+  if (s == S_LIGHTBULB)
+    SQUARE(g, i, j) = s | F_LIGHTED | (seen ? F_ERROR : 0);
+  else
+    SQUARE(g, i, j) = s | (seen ? F_LIGHTED : 0);
+}
+
+/* ************************************************************************** */
+
+/* recompute the flags of the walls next to (i,j) */
+static void _update_walls_flags(game g, uint i, uint j) {
+  for (uint dir = UP; dir <= RIGHT; dir++) {
+    int ii = i, jj = j;
+    if (_next(g, &ii, &jj, dir) && (STATE(g, ii, jj) & S_BLACK))
+      _update_square_flags(g, ii, jj);
+  }
+}
+
+/* ************************************************************************** */
+
+/* apply f to (i,j) and to all the squares in sight of (i,j) */
+static void _foreach_in_sight(game g, uint i, uint j,
+                              void (*f)(game, uint, uint)) {
+  f(g, i, j);
+  uint cells[MAX(g->nb_rows, g->nb_cols)];
+  for (uint dir = UP; dir <= RIGHT; dir++) {
+    uint n = _ray(g, i, j, dir, cells);
+    int ii = i, jj = j;  // the coordinates follow the ray, without division
+    for (uint k = 0; k < n; k++) {
+      _next(g, &ii, &jj, dir);
+      f(g, ii, jj);
+    }
+  }
+}
+
+/* ************************************************************************** */
+
+void _update_flags_around(game g, uint i, uint j) {
+  assert(g);
+  assert(i < g->nb_rows);
+  assert(j < g->nb_cols);
+  _own_squares(g);
+
+  // 1) only the squares in sight of (i,j) may change of light or error, since
+  // the line of sight is symmetric
+  _foreach_in_sight(g, i, j, _update_square_flags);
+
+  // 2) then the walls next to them, once the lighted flags are up to date
+  _foreach_in_sight(g, i, j, _update_walls_flags);
+}
+
+/* ************************************************************************** */
+
+void _flags_touch(game g, uint i, uint j) {
+  assert(g);
+  assert(i < g->nb_rows);
+  assert(j < g->nb_cols);
+  // flags set by hand may be wrong anywhere, and a move only fixes the
+  // squares in sight: a full update is cheaper beyond r*c/(r+c) moves
+  size_t limit = (size_t)g->nb_rows * g->nb_cols / (g->nb_rows + g->nb_cols);
+  if (g->stale || g->edited || limit == 0) {
+    g->stale = true;
+    return;
+  }
+  uint k = INDEX(g, i, j);
+  for (uint l = 0; l < g->nb_touched; l++)
+    if (g->touched[l] == k) return;  // already pending
+  if (g->nb_touched == limit) {
+    g->stale = true;
+    g->nb_touched = 0;
+    return;
+  }
+  if (!g->touched) {
+    g->touched = malloc(limit * sizeof(uint));
+    assert(g->touched);
+  }
+  g->touched[g->nb_touched++] = k;
+}
+
+/* ************************************************************************** */
+
+void _flags_resolve(cgame cg) {
+  assert(cg);
+  if (!cg->stale && cg->nb_touched == 0) return;
+  game g = (game)cg;  // only the flags are written
+  if (g->stale) {
+    _compute_flags(g);
+    g->edited = false;
+  } else {
+    // each update fixes the squares in sight of its move from their states,
+    // and the walls next to them: they don't depend on their order
+    for (uint l = 0; l < g->nb_touched; l++)
+      _update_flags_around(g, g->touched[l] / g->nb_cols,
+                           g->touched[l] % g->nb_cols);
+  }
+  g->stale = false;
+  g->nb_touched = 0;
+}
+
+/* ************************************************************************** */
+
 bool game_check_move(cgame g, uint i, uint j, square s) {
   assert(g);
   if (i > g->nb_rows - 1) return false;
@@ -231,30 +347,32 @@ void game_play_move(game g, uint i, uint j, square s) {
   bool black = game_is_black(g, i, j);
   if (black) exit(EXIT_FAILURE);
   square cs = STATE(g, i, j);  // save current state
-  SQUARE(g, i, j) = s;         // update with new state
+  _own_squares(g);
+  SQUARE(g, i, j) = s;  // update with new state
 
-  // update flags
-  game_update_flags(g);
+  // update flags, lazily
+  _flags_touch(g, i, j);
 
   // save history
-  _stack_clear(g->redo_stack);
-  move m = {i, j, cs, s};
-  _stack_push_move(g->undo_stack, m);
+  move m = {i, j, cs, s, false};
+  _history_push(g, m);
+  if (g->journal) _journal_append(g);
 }
 
 /* ************************************************************************** */
 
 bool game_is_over(cgame g) {
   assert(g);
+  _flags_resolve(g);
 
-  for (uint i = 0; i < g->nb_rows; i++)
-    for (uint j = 0; j < g->nb_cols; j++) {
-      // 1) check that square is lighted (except if it is a wall)
-      if (!game_is_black(g, i, j) && !game_is_lighted(g, i, j)) return false;
+  GAME_FOREACH(g, i, j) {
+    // 1) check that square is lighted (except if it is a wall)
+    if (!game_fast_is_black(g, i, j) && !game_fast_is_lighted(g, i, j))
+      return false;
 
-      // 2) check if there are no errors
-      if (game_has_error(g, i, j)) return false;
-    }
+    // 2) check if there are no errors
+    if (game_fast_has_error(g, i, j)) return false;
+  }
 
   return true;
 }
@@ -263,6 +381,7 @@ bool game_is_over(cgame g) {
 
 void game_restart(game g) {
   assert(g);
+  _own_squares(g);
 
   for (uint i = 0; i < g->nb_rows; i++)
     for (uint j = 0; j < g->nb_cols; j++) {
@@ -272,10 +391,14 @@ void game_restart(game g) {
       else  // blank other
         SQUARE(g, i, j) = S_BLANK;
     }
+  // the flags are cleared, not computed
+  g->stale = false;
+  g->nb_touched = 0;
+  g->edited = true;
 
   // reset history
-  _stack_clear(g->undo_stack);
-  _stack_clear(g->redo_stack);
+  _history_clear(g);
+  if (g->journal) _journal_append(g);
 }
 
 /* ************************************************************************** */
@@ -342,6 +465,7 @@ bool game_is_lighted(cgame g, uint i, uint j) {
   assert(g);
   assert(i < g->nb_rows);
   assert(j < g->nb_cols);
+  _flags_resolve(g);
   square f = FLAGS(g, i, j);
   if (f & F_LIGHTED) return true;
   return false;
@@ -353,6 +477,7 @@ bool game_has_error(cgame g, uint i, uint j) {
   assert(g);
   assert(i < g->nb_rows);
   assert(j < g->nb_cols);
+  _flags_resolve(g);
   square f = FLAGS(g, i, j);
   if (f & F_ERROR) return true;
   return false;
@@ -66,7 +66,15 @@ typedef struct game_s *game;
 /**
  * @brief The structure constant pointer that stores the game state.
  * @details That means that it is not possible to modify the game using this
- * pointer.
+ * pointer. However, the flags are updated lazily: after a move or
+ * game_update_flags(), the first query that reads the flags (game_get_square,
+ * game_get_flags, game_is_lighted, game_has_error, game_is_over,
+ * game_equal...) writes them into the game. While flags are pending, queries
+ * on the same game are therefore not thread-safe, and may copy the grid of a
+ * view. game_copy() only reads its source. The games handed out by the
+ * library (copied, loaded, decoded, restored or solved) have their flags
+ * computed, so that their queries are pure reads until the next
+ * modification.
  **/
 typedef const struct game_s *cgame;
 
@@ -115,7 +123,7 @@ void game_delete(game g);
 /**
  * @brief Sets the value of a given square.
  * @details This function is useful for initializing the squares of an empty
- * game.
+ * game. The square is stored as is: its flags are not updated.
  * @param g the game
  * @param i row index
  * @param j column index
@@ -287,7 +295,9 @@ void game_play_move(game g, uint i, uint j, square s);
 /**
  * @brief Update all grid flags.
  * @details This is a low-level function, which is not intended to be used
- * directly by end-user during the game.
+ * directly by end-user during the game. The flags are recomputed lazily, on
+ * their first query, so that several updates in a row cost a single one (see
+ * @ref cgame).
  * @param g the game
  * @pre @p g must be a valid pointer toward a game structure.
  **/
@@ -12,6 +12,7 @@
 
 #include "game.h"
 #include "game_ext.h"
+#include "game_fast.h"
 #include "game_private.h"
 
 /* ************************************************************************** */
@@ -27,7 +28,7 @@ void game_print(cgame g) {
   for (uint i = 0; i < game_nb_rows(g); i++) {
     printf("%d |", i);
     for (uint j = 0; j < game_nb_cols(g); j++) {
-      square s = game_get_square(g, i, j);
+      square s = game_fast_square(g, i, j);
       char c = _square2str(s);
       printf("%c", c);
     }
@@ -0,0 +1,117 @@
+/**
+ * @file game_bench.c
+ * @brief Benchmark of the checked and unchecked game accessors.
+ * @details Usage: game_bench [<size>] [<rounds>]. Compare the timings of a
+ * RELEASE build, the asserts of the checked accessors being kept otherwise.
+ * @copyright University of Bordeaux. All rights reserved, 2021.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "game.h"
+#include "game_ext.h"
+#include "game_fast.h"
+
+/* ************************************************************************** */
+
+/* a square board with walls and light bulbs scattered over it */
+static game _board(uint size) {
+  game g = game_new_empty_ext(size, size, false);
+  for (uint k = 0; k < size * size; k += 5)
+    game_set_square(g, k / size, (k * 7) % size, S_BLACKU);
+  for (uint k = 1; k < size * size; k += 11)
+    if (!game_is_black(g, k / size, k % size))
+      game_set_square(g, k / size, k % size, S_LIGHTBULB);
+  game_update_flags(g);
+  return g;
+}
+
+/* ************************************************************************** */
+
+/* the queries of a renderer for each square, with the checked accessors */
+static uint _scan_checked(cgame g) {
+  uint n = 0;
+  for (uint i = 0; i < game_nb_rows(g); i++)
+    for (uint j = 0; j < game_nb_cols(g); j++) {
+      if (game_is_black(g, i, j)) n += game_get_black_number(g, i, j);
+      n += game_is_blank(g, i, j) + game_is_lighted(g, i, j);
+      n += game_is_lightbulb(g, i, j) + game_has_error(g, i, j);
+    }
+  return n;
+}
+
+/* ************************************************************************** */
+
+/* the same queries with the unchecked accessors */
+static uint _scan_fast(cgame g) {
+  uint n = 0;
+  GAME_FOREACH(g, i, j) {
+    if (game_fast_is_black(g, i, j)) n += game_fast_black_number(g, i, j);
+    n += game_fast_is_blank(g, i, j) + game_fast_is_lighted(g, i, j);
+    n += game_fast_is_lightbulb(g, i, j) + game_fast_has_error(g, i, j);
+  }
+  return n;
+}
+
+/* ************************************************************************** */
+
+/* game_is_over() written with the checked accessors */
+static uint _over_checked(cgame g) {
+  for (uint i = 0; i < game_nb_rows(g); i++)
+    for (uint j = 0; j < game_nb_cols(g); j++) {
+      if (!game_is_black(g, i, j) && !game_is_lighted(g, i, j)) return 0;
+      if (game_has_error(g, i, j)) return 0;
+    }
+  return 1;
+}
+
+/* ************************************************************************** */
+
+static uint _over_fast(cgame g) { return game_is_over(g); }
+
+/* ************************************************************************** */
+
+/* nanoseconds per square of a scan */
+static double _time(uint (*scan)(cgame), cgame g, uint rounds, uint *sink) {
+  clock_t t = clock();
+  for (uint r = 0; r < rounds; r++) *sink += scan(g);
+  double s = (double)(clock() - t) / CLOCKS_PER_SEC;
+  return 1e9 * s / rounds / (game_nb_rows(g) * game_nb_cols(g));
+}
+
+/* ************************************************************************** */
+
+int main(int argc, char *argv[]) {
+  uint size = (argc > 1) ? atoi(argv[1]) : 50;
+  uint rounds = (argc > 2) ? atoi(argv[2]) : 2000;
+  if (size == 0 || rounds == 0) {
+    fprintf(stderr, "Usage: %s [<size>] [<rounds>]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  game g = _board(size);
+  game solved = game_new_empty_ext(size, size, false);
+  for (uint i = 0; i < size; i++)  // each bulb lights its row and column
+    game_set_square(solved, i, i, S_LIGHTBULB);
+  game_update_flags(solved);
+
+  struct {
+    const char *name;
+    uint (*checked)(cgame), (*fast)(cgame);
+    cgame g;
+  } benches[] = {{"render scan", _scan_checked, _scan_fast, g},
+                 {"game_is_over", _over_checked, _over_fast, solved}};
+  uint sink = 0;
+  printf("%ux%u board, %u rounds (ns per square)\n", size, size, rounds);
+  printf("%-14s %10s %10s %8s\n", "loop", "checked", "fast", "speedup");
+  for (uint b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+    double tc = _time(benches[b].checked, benches[b].g, rounds, &sink);
+    double tf = _time(benches[b].fast, benches[b].g, rounds, &sink);
+    printf("%-14s %10.2f %10.2f %7.1fx\n", benches[b].name, tc, tf,
+           tf > 0 ? tc / tf : 0);
+  }
+  game_delete(g);
+  game_delete(solved);
+  return (sink == 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
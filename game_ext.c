@@ -9,10 +9,10 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "game.h"
 #include "game_private.h"
-#include "queue.h"
 
 /* ************************************************************************** */
 /*                                 GAME EXT                                   */
@@ -38,19 +38,65 @@ game game_new_empty_ext(uint nb_rows, uint nb_cols, bool wrapping) {
   g->nb_rows = nb_rows;
   g->nb_cols = nb_cols;
   g->wrapping = wrapping;
+  g->topo = _topology(wrapping);
   g->squares = (square *)calloc(g->nb_rows * g->nb_cols, sizeof(uint));
   assert(g->squares);
+  g->owned = true;
 
   // initialize history
-  g->undo_stack = queue_new();
-  assert(g->undo_stack);
-  g->redo_stack = queue_new();
-  assert(g->redo_stack);
+  _history_init(g);
+
+  // the flags are computed at the first move
+  g->touched = NULL;
+  g->nb_touched = 0;
+  g->stale = false;
+  g->edited = true;
+  g->shown = NULL;  // all the squares are changed
   return g;
 }
 
 /* ************************************************************************** */
 
+game game_new_view(uint nb_rows, uint nb_cols, const square *squares,
+                   bool wrapping) {
+  assert(squares);
+  game g = (game)malloc(sizeof(struct game_s));
+  assert(g);
+  g->nb_rows = nb_rows;
+  g->nb_cols = nb_cols;
+  g->wrapping = wrapping;
+  g->topo = _topology(wrapping);
+  g->squares = (square *)squares;  // never written while not owned
+  g->owned = false;
+
+  // initialize history
+  _history_init(g);
+
+  // the flags are computed at the first move
+  g->touched = NULL;
+  g->nb_touched = 0;
+  g->stale = false;
+  g->edited = true;
+  g->shown = NULL;  // all the squares are changed
+  return g;
+}
+
+/* ************************************************************************** */
+
+void game_rebind_view(game g, const square *squares) {
+  assert(g && squares);
+  if (g->owned) free(g->squares);
+  g->squares = (square *)squares;
+  g->owned = false;
+  g->stale = false;
+  g->nb_touched = 0;
+  g->edited = true;
+  // reset history
+  _history_clear(g);
+}
+
+/* ************************************************************************** */
+
 uint game_nb_rows(cgame g) { return g->nb_rows; }
 
 /* ************************************************************************** */
@@ -65,22 +111,93 @@ bool game_is_wrapping(cgame g) { return g->wrapping; }
 
 void game_undo(game g) {
   assert(g);
-  if (_stack_is_empty(g->undo_stack)) return;
-  move m = _stack_pop_move(g->undo_stack);
-  game_set_square(g, m.i, m.j, m.old);
-  game_update_flags(g);
-  _stack_push_move(g->redo_stack, m);
+  if (g->cursor == 0) return;
+  // the moves of a transaction are undone together
+  _own_squares(g);
+  do {
+    move m = g->history[--g->cursor];
+    SQUARE(g, m.i, m.j) = m.old;
+    _flags_touch(g, m.i, m.j);
+  } while (g->cursor > 0 && g->history[g->cursor].linked);
+  if (g->journal) _journal_append(g);
 }
 
 /* ************************************************************************** */
 
 void game_redo(game g) {
   assert(g);
-  if (_stack_is_empty(g->redo_stack)) return;
-  move m = _stack_pop_move(g->redo_stack);
-  game_set_square(g, m.i, m.j, m.new);
-  game_update_flags(g);
-  _stack_push_move(g->undo_stack, m);
+  if (g->cursor == g->nb_moves) return;
+  _own_squares(g);
+  do {
+    move m = g->history[g->cursor++];
+    SQUARE(g, m.i, m.j) = m.new;
+    _flags_touch(g, m.i, m.j);
+  } while (g->cursor < g->nb_moves && g->history[g->cursor].linked);
+  if (g->journal) _journal_append(g);
+}
+
+/* ************************************************************************** */
+
+bool game_play_moves(game g, const game_move *moves, uint n) {
+  assert(g && (moves || n == 0));
+  for (uint k = 0; k < n; k++)
+    if (!game_check_move(g, moves[k].i, moves[k].j, moves[k].s)) return false;
+  if (n == 0) return true;
+  _own_squares(g);
+  for (uint k = 0; k < n; k++) {
+    move m = {moves[k].i, moves[k].j, STATE(g, moves[k].i, moves[k].j),
+              moves[k].s, k > 0};
+    SQUARE(g, m.i, m.j) = m.new;
+    _history_push(g, m);
+    _flags_touch(g, m.i, m.j);
+  }
+  if (g->journal) _journal_append(g);
+  return true;
+}
+
+/* ************************************************************************** */
+
+uint game_changed_cells(cgame g, uint *cells, uint cap) {
+  assert(g && (cells || cap == 0));
+  _flags_resolve(g);
+  uint size = g->nb_rows * g->nb_cols, n = 0;
+  for (uint k = 0; k < size; k++)
+    if (!g->shown || g->squares[k] != g->shown[k]) {
+      if (n < cap) cells[n] = k;
+      n++;
+    }
+  return n;
+}
+
+/* ************************************************************************** */
+
+void game_ack_changes(game g) {
+  assert(g);
+  _flags_resolve(g);
+  size_t size = (size_t)g->nb_rows * g->nb_cols * sizeof(square);
+  if (!g->shown) {
+    g->shown = malloc(size);
+    assert(g->shown);
+  }
+  memcpy(g->shown, g->squares, size);
+}
+
+/* ************************************************************************** */
+
+void game_export_squares(cgame g, uint8_t *out) {
+  assert(g);
+  game_export_rows(g, 0, g->nb_rows, out);
+}
+
+/* ************************************************************************** */
+
+void game_export_rows(cgame g, uint first, uint nb, uint8_t *out) {
+  assert(g && (out || nb == 0));
+  assert(first <= g->nb_rows && nb <= g->nb_rows - first);
+  _flags_resolve(g);
+  const square *squares = g->squares + (size_t)first * g->nb_cols;
+  size_t size = (size_t)nb * g->nb_cols;
+  for (size_t k = 0; k < size; k++) out[k] = squares[k];
 }
 
 /* ************************************************************************** */
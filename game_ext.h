@@ -9,6 +9,7 @@
 #define __GAME_EXT_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "game.h"
 
@@ -17,6 +18,14 @@
  * @{
  */
 
+/**
+ * @brief A move, as played by @ref game_play_moves.
+ **/
+typedef struct {
+  uint i, j; /**< square of the move */
+  square s;  /**< new state: S_BLANK, S_LIGHTBULB or S_MARK */
+} game_move;
+
 /**
  * @brief Creates a new game with extended options and initializes it.
  * @details See description of game extensions on @ref index.
@@ -29,6 +38,34 @@
  **/
 game game_new_ext(uint nb_rows, uint nb_cols, square *squares, bool wrapping);
 
+/**
+ * @brief Creates a game that borrows an existing array of squares.
+ * @details Unlike @ref game_new_ext, the squares are not copied: queries read
+ * the array directly, flags included. The first modification of the game
+ * copies the array into a private one (copy-on-write), so the array is never
+ * written. It must stay valid until the game is deleted, rebound or modified.
+ * @param nb_rows number of rows in game
+ * @param nb_cols number of columns in game
+ * @param squares an array describing the state of each square (row-major
+ * storage)
+ * @param wrapping wrapping option
+ * @return the created game
+ **/
+game game_new_view(uint nb_rows, uint nb_cols, const square *squares,
+                   bool wrapping);
+
+/**
+ * @brief Makes a game borrow another array of squares.
+ * @details The game becomes a view of @p squares, with the same dimensions
+ * and wrapping option, and its history is cleared. A whole set of grids can
+ * be scanned this way with game_is_over() and a single game, with no
+ * allocation. The solver routines of game_tools.h still allocate their own
+ * structures on each call.
+ * @param g the game
+ * @param squares an array of game_nb_rows(g) * game_nb_cols(g) squares
+ **/
+void game_rebind_view(game g, const square *squares);
+
 /**
  * @brief Creates a new empty game with extended options.
  * @details All squares are initialized with empty squares.
@@ -68,7 +105,8 @@ bool game_is_wrapping(cgame g);
  * @details Searches in the history the last move played (by calling
  * @ref game_play_move or @ref game_redo), and restores the state of the game
  * before that move. If no moves have been played, this function does nothing.
- * The @ref game_restart function clears the history.
+ * The @ref game_restart function clears the history. The moves played by
+ * @ref game_play_moves are undone together.
  * @param g the game
  * @pre @p g is a valid pointer toward a cgame structure
  **/
@@ -79,12 +117,78 @@ void game_undo(game g);
  * @details Searches in the history the last cancelled move (by calling @ref
  * game_undo), and replays it. If there are no more moves to be replayed, this
  * function does nothing. After playing a new move with @ref game_play_move, it
- * is no longer possible to redo an old cancelled move.
+ * is no longer possible to redo an old cancelled move. The moves played by
+ * @ref game_play_moves are redone together.
  * @param g the game
  * @pre @p g is a valid pointer toward a cgame structure
  **/
 void game_redo(game g);
 
+/**
+ * @brief Plays several moves as a single transaction.
+ * @details The moves are played in order, as with @ref game_play_move, but
+ * the flags are updated once, only around the squares played when it is
+ * cheaper, and the moves are undone and redone together by @ref game_undo
+ * and @ref game_redo.
+ * @param g the game
+ * @param moves the moves to play
+ * @param n the number of moves
+ * @pre @p g is a valid pointer toward a game structure, with its flags up to
+ * date
+ * @return false if one of the moves is not legal (see game_check_move()), in
+ * which case no move is played
+ **/
+bool game_play_moves(game g, const game_move *moves, uint n);
+
+/**
+ * @brief Lists the squares changed since the last acknowledgement.
+ * @details A square is changed when its state or its flags differ from their
+ * value at the last call to @ref game_ack_changes, so that a renderer only
+ * repaints these squares. All the squares are changed before the first
+ * acknowledgement. The squares are given by their index i*nb_cols+j, in
+ * increasing order.
+ * @param g the game
+ * @param cells an array receiving the indices of the first changed squares
+ * @param cap the capacity of @p cells (0 to only count the changed squares)
+ * @pre @p g is a valid pointer toward a game structure
+ * @return the number of changed squares, that may be more than @p cap
+ **/
+uint game_changed_cells(cgame g, uint *cells, uint cap);
+
+/**
+ * @brief Acknowledges the changes of the squares.
+ * @details Once called, no square is changed until the next modification of
+ * the game (see @ref game_changed_cells).
+ * @param g the game
+ * @pre @p g is a valid pointer toward a game structure
+ **/
+void game_ack_changes(game g);
+
+/**
+ * @brief Copies the squares of the game into a byte array.
+ * @details Each square is copied as its raw value (see @ref game_get_square),
+ * which fits in a byte, row after row: the square (i,j) is copied at index
+ * i*nb_cols+j. This is a single call for a renderer, instead of one call per
+ * accessor and square.
+ * @param g the game
+ * @param out an array of nb_rows*nb_cols bytes receiving the squares
+ * @pre @p g is a valid pointer toward a game structure
+ **/
+void game_export_squares(cgame g, uint8_t *out);
+
+/**
+ * @brief Copies some rows of the game into a byte array.
+ * @details Same as @ref game_export_squares, for the rows @p first to
+ * @p first+nb-1 only: the square (first+i,j) is copied at index i*nb_cols+j.
+ * @param g the game
+ * @param first the first row to copy
+ * @param nb the number of rows to copy
+ * @param out an array of nb*nb_cols bytes receiving the squares
+ * @pre @p g is a valid pointer toward a game structure
+ * @pre @p first + @p nb <= game height
+ **/
+void game_export_rows(cgame g, uint first, uint nb, uint8_t *out);
+
 /**
  * @}
  */
@@ -0,0 +1,76 @@
+/**
+ * @file game_fast.h
+ * @brief Unchecked Game Accessors.
+ * @details Inline versions of the accessors of game.h, for the loops of the
+ * library and of trusted callers over many squares: the arguments are not
+ * checked, and (i,j) must be inside the board. The checked functions of
+ * game.h remain the public API.
+ * @copyright University of Bordeaux. All rights reserved, 2021.
+ **/
+
+#ifndef __GAME_FAST_H__
+#define __GAME_FAST_H__
+
+#include <stdbool.h>
+
+#include "game.h"
+#include "game_private.h"
+
+/** iterate over the squares (i,j) of a game, row after row */
+#define GAME_FOREACH(g, i, j)               \
+  for (uint i = 0; i < (g)->nb_rows; i++) \
+    for (uint j = 0; j < (g)->nb_cols; j++)
+
+/** same as game_get_square(), unchecked */
+static inline square game_fast_square(cgame g, uint i, uint j) {
+  if (g->stale || g->nb_touched) _flags_resolve(g);
+  return SQUARE(g, i, j);
+}
+
+/** same as game_get_state(), unchecked */
+static inline square game_fast_state(cgame g, uint i, uint j) {
+  return STATE(g, i, j);
+}
+
+/** same as game_get_flags(), unchecked */
+static inline square game_fast_flags(cgame g, uint i, uint j) {
+  return game_fast_square(g, i, j) & F_MASK;
+}
+
+/** same as game_is_blank(), unchecked */
+static inline bool game_fast_is_blank(cgame g, uint i, uint j) {
+  return STATE(g, i, j) == S_BLANK;
+}
+
+/** same as game_is_lightbulb(), unchecked */
+static inline bool game_fast_is_lightbulb(cgame g, uint i, uint j) {
+  return STATE(g, i, j) == S_LIGHTBULB;
+}
+
+/** same as game_is_black(), unchecked */
+static inline bool game_fast_is_black(cgame g, uint i, uint j) {
+  return (STATE(g, i, j) & S_BLACK) != 0;
+}
+
+/** same as game_get_black_number(), unchecked */
+static inline int game_fast_black_number(cgame g, uint i, uint j) {
+  square s = STATE(g, i, j);
+  return (s == S_BLACKU) ? -1 : (int)(s - S_BLACK);
+}
+
+/** same as game_is_marked(), unchecked */
+static inline bool game_fast_is_marked(cgame g, uint i, uint j) {
+  return STATE(g, i, j) == S_MARK;
+}
+
+/** same as game_is_lighted(), unchecked */
+static inline bool game_fast_is_lighted(cgame g, uint i, uint j) {
+  return (game_fast_square(g, i, j) & F_LIGHTED) != 0;
+}
+
+/** same as game_has_error(), unchecked */
+static inline bool game_fast_has_error(cgame g, uint i, uint j) {
+  return (game_fast_square(g, i, j) & F_ERROR) != 0;
+}
+
+#endif  // __GAME_FAST_H__
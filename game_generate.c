@@ -0,0 +1,238 @@
+/**
+ * @file game_generate.c
+ * @brief Bulk Game Generator.
+ * @details Generates many distinct random games of a given size, wall
+ * density and difficulty, using one worker thread per core. Games are written
+ * one after the other in the file format of game_save, or in a pack. Games
+ * that are rotations or reflections of each other count as the same game.
+ * @copyright University of Bordeaux. All rights reserved, 2021.
+ **/
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "game.h"
+#include "game_aux.h"
+#include "game_ext.h"
+#include "game_tools.h"
+
+/** maximum number of games tried per game requested */
+#define MAX_TRIES 1000
+
+/* ************************************************************************** */
+
+/** state shared by the workers */
+typedef struct {
+  /* parameters */
+  uint nb_games, nb_rows, nb_cols, nb_walls, min_score, max_score;
+  bool wrapping;
+  uint64_t seed;
+  FILE* out;     /**< text output, NULL for a pack */
+  cgame* games;  /**< games kept for the pack */
+
+  /* shared state, protected by lock */
+  pthread_mutex_t lock;
+  uint nb_done;            /**< number of games written */
+  unsigned long nb_tries;  /**< number of games generated */
+  uint64_t* hashes;        /**< open addressing set of game hashes */
+  uint hash_mask;          /**< size of the set minus one */
+} pool;
+
+/** worker parameters */
+typedef struct {
+  pool* p;
+  uint id;
+} worker;
+
+/* ************************************************************************** */
+
+/* hash of the walls of a game, the same for its rotations and reflections */
+static uint64_t _hash(cgame g) {
+  uint64_t h = game_canonical_hash(g);
+  return h ? h : 1;  // 0 is an empty slot
+}
+
+/* ************************************************************************** */
+
+/* add a hash to the set, return false if it was already there */
+static bool _insert(pool* p, uint64_t h) {
+  uint k = h & p->hash_mask;
+  while (p->hashes[k]) {
+    if (p->hashes[k] == h) return false;
+    k = (k + 1) & p->hash_mask;
+  }
+  p->hashes[k] = h;
+  return true;
+}
+
+/* ************************************************************************** */
+
+static void _fprint_game(FILE* f, cgame g) {
+  size_t len = game_save_mem(g, NULL, 0);
+  char* buf = malloc(len + 1);
+  assert(buf);
+  game_save_mem(g, buf, len + 1);
+  fwrite(buf, 1, len, f);
+  free(buf);
+}
+
+/* ************************************************************************** */
+
+/* first seed of a worker: one splitmix64 output, so that the streams of the
+ * workers are not the same stream shifted by a few draws */
+static uint64_t _worker_seed(uint64_t seed, uint id) {
+  uint64_t z = (seed ^ id) + 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/* ************************************************************************** */
+
+static void* _work(void* arg) {
+  worker* w = arg;
+  pool* p = w->p;
+  // each worker has its own stream of seeds
+  uint64_t seed = _worker_seed(p->seed, w->id);
+  bool done = false;
+
+  while (!done) {
+    game g = game_random_ext(p->nb_rows, p->nb_cols, p->wrapping, p->nb_walls,
+                             false, seed++);
+    bool keep = false;
+    if (g) {
+      grade r = game_grade(g);
+      keep = (r.score >= p->min_score && r.score <= p->max_score);
+    }
+    uint64_t h = keep ? _hash(g) : 0;
+
+    pthread_mutex_lock(&p->lock);
+    p->nb_tries++;
+    if (keep && p->nb_done < p->nb_games && _insert(p, h)) {
+      if (p->out)
+        _fprint_game(p->out, g);
+      else {
+        p->games[p->nb_done] = g;
+        g = NULL;  // kept
+      }
+      p->nb_done++;
+    }
+    done = (p->nb_done == p->nb_games ||
+            p->nb_tries >= (unsigned long)MAX_TRIES * p->nb_games);
+    pthread_mutex_unlock(&p->lock);
+    if (g) game_delete(g);
+  }
+  return NULL;
+}
+
+/* ************************************************************************** */
+
+static void usage(char* cmd) {
+  fprintf(stderr,
+          "usage: %s <nb_games> <nb_rows> <nb_cols> <walls%%> [-w] "
+          "[-d min max] [-j nb_threads] [-s seed] [-o file | -p pack]\n",
+          cmd);
+  exit(EXIT_FAILURE);
+}
+
+/* ************************************************************************** */
+
+int main(int argc, char* argv[]) {
+  if (argc < 5) usage(argv[0]);
+  pool p = {0};
+  p.nb_games = atoi(argv[1]);
+  p.nb_rows = atoi(argv[2]);
+  p.nb_cols = atoi(argv[3]);
+  uint density = atoi(argv[4]);
+  if (p.nb_rows == 0 || p.nb_cols == 0 || density > 100) usage(argv[0]);
+  p.nb_walls = p.nb_rows * p.nb_cols * density / 100;
+  p.max_score = (uint)-1;
+  p.seed = time(NULL);
+  p.out = stdout;
+  long nb_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  char* filename = NULL;
+  char* packname = NULL;
+
+  for (int k = 5; k < argc; k++) {
+    if (strcmp(argv[k], "-w") == 0)
+      p.wrapping = true;
+    else if (strcmp(argv[k], "-d") == 0 && k + 2 < argc) {
+      p.min_score = atoi(argv[++k]);
+      p.max_score = atoi(argv[++k]);
+    } else if (strcmp(argv[k], "-j") == 0 && k + 1 < argc)
+      nb_threads = atoi(argv[++k]);
+    else if (strcmp(argv[k], "-s") == 0 && k + 1 < argc)
+      p.seed = strtoull(argv[++k], NULL, 10);
+    else if (strcmp(argv[k], "-o") == 0 && k + 1 < argc)
+      filename = argv[++k];
+    else if (strcmp(argv[k], "-p") == 0 && k + 1 < argc)
+      packname = argv[++k];
+    else
+      usage(argv[0]);
+  }
+  if (nb_threads < 1) nb_threads = 1;
+
+  if (packname) {
+    p.out = NULL;
+    p.games = calloc(p.nb_games + 1, sizeof(cgame));
+    assert(p.games);
+  } else if (filename) {
+    p.out = fopen(filename, "w");
+    if (!p.out) {
+      fprintf(stderr, "ERROR: Failed to open the file!\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  uint size = 1;
+  while (size < 2 * p.nb_games) size *= 2;
+  p.hashes = calloc(size, sizeof(uint64_t));
+  assert(p.hashes);
+  p.hash_mask = size - 1;
+  pthread_mutex_init(&p.lock, NULL);
+
+  pthread_t* threads = malloc(nb_threads * sizeof(pthread_t));
+  worker* workers = malloc(nb_threads * sizeof(worker));
+  assert(threads && workers);
+  long nb_started = 0;
+  for (long t = 0; t < nb_threads; t++) {
+    workers[t] = (worker){&p, t};
+    if (pthread_create(&threads[t], NULL, _work, &workers[t]) != 0) break;
+    nb_started++;
+  }
+  if (nb_started == 0) {
+    workers[0] = (worker){&p, 0};
+    _work(&workers[0]);  // no thread available: work in the main thread
+  }
+  for (long t = 0; t < nb_started; t++) pthread_join(threads[t], NULL);
+
+  if (filename && p.out) fclose(p.out);
+  int status = EXIT_SUCCESS;
+  if (packname) {
+    game_error err = game_pack_write(packname, p.games, p.nb_done);
+    if (err != GAME_OK) {
+      fprintf(stderr, "ERROR: %s: %s!\n", packname, game_strerror(err));
+      status = EXIT_FAILURE;
+    }
+    for (uint k = 0; k < p.nb_done; k++) game_delete((game)p.games[k]);
+    free(p.games);
+  }
+  pthread_mutex_destroy(&p.lock);
+  free(workers);
+  free(threads);
+  free(p.hashes);
+
+  if (p.nb_done < p.nb_games) {
+    fprintf(stderr, "only %u games generated out of %u\n", p.nb_done,
+            p.nb_games);
+    return EXIT_FAILURE;
+  }
+  return status;
+}
@@ -9,47 +9,47 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "game.h"
 #include "game_ext.h"
-#include "queue.h"
 
 /* ************************************************************************** */
-/*                             STACK ROUTINES                                 */
+/*                            HISTORY ROUTINES                                */
 /* ************************************************************************** */
 
-void _stack_push_move(queue *q, move m) {
-  assert(q);
-  move *pm = malloc(sizeof(move));
-  assert(pm);
-  *pm = m;
-  queue_push_head(q, pm);
+void _history_init(game g) {
+  g->history = NULL;
+  g->nb_moves = 0;
+  g->cursor = 0;
+  g->capacity = 0;
+  g->synced = 0;
+  g->cleared = false;
+  g->journal = NULL;
 }
 
 /* ************************************************************************** */
 
-move _stack_pop_move(queue *q) {
-  assert(q);
-  move *pm = queue_pop_head(q);
-  assert(pm);
-  move m = *pm;
-  free(pm);
-  return m;
-}
-
-/* ************************************************************************** */
-
-bool _stack_is_empty(queue *q) {
-  assert(q);
-  return queue_is_empty(q);
+void _history_push(game g, move m) {
+  assert(g);
+  if (g->cursor == g->capacity) {
+    g->capacity = g->capacity ? 2 * g->capacity : 16;
+    g->history = realloc(g->history, g->capacity * sizeof(move));
+    assert(g->history);
+  }
+  if (g->synced > g->cursor) g->synced = g->cursor;
+  g->history[g->cursor++] = m;
+  g->nb_moves = g->cursor;  // the undone moves are lost
 }
 
 /* ************************************************************************** */
 
-void _stack_clear(queue *q) {
-  assert(q);
-  queue_clear_full(q, free);
-  assert(queue_is_empty(q));
+void _history_clear(game g) {
+  assert(g);
+  g->nb_moves = 0;
+  g->cursor = 0;
+  g->synced = 0;
+  g->cleared = true;
 }
 
 /* ************************************************************************** */
@@ -93,6 +93,16 @@ bool _check_square(square s) {
   return true;
 }
 
+void _own_squares(game g) {
+  if (g->owned) return;
+  size_t size = g->nb_rows * g->nb_cols * sizeof(square);
+  square *squares = malloc(size);
+  assert(squares);
+  memcpy(squares, g->squares, size);
+  g->squares = squares;
+  g->owned = true;
+}
+
 /* ************************************************************************** */
 /*                                 NEIGHBORHOOD                               */
 /* ************************************************************************** */
@@ -107,19 +117,138 @@ static int j_offset[] = {[HERE] = 0,     [UP] = 0,         [DOWN] = 0,
 
 /* ************************************************************************** */
 
-bool _inside(cgame g, int i, int j) {
-  assert(g);
-  if (game_is_wrapping(g)) {
-    i = (i + game_nb_rows(g)) % game_nb_rows(g);
-    j = (j + game_nb_cols(g)) % game_nb_cols(g);
+/* the position of a coordinate one board size at most out of the board */
+static int _wrap(int x, uint n) {
+  if (x < 0) return x + (int)n;
+  if (x >= (int)n) return x - (int)n;
+  return x;
+}
+
+/* ************************************************************************** */
+
+/* number of squares from (i,j) to the border of the board in a direction */
+static uint _to_border(cgame g, uint i, uint j, direction dir) {
+  switch (dir) {
+    case UP:
+      return i;
+    case DOWN:
+      return g->nb_rows - 1 - i;
+    case LEFT:
+      return j;
+    default:
+      return g->nb_cols - 1 - j;
+  }
+}
+
+/* ************************************************************************** */
+
+static bool _inside_plain(cgame g, int i, int j) {
+  return i >= 0 && j >= 0 && i < (int)g->nb_rows && j < (int)g->nb_cols;
+}
+
+/* ************************************************************************** */
+
+static bool _inside_wrapping(cgame g, int i, int j) {
+  return i >= -(int)g->nb_rows && j >= -(int)g->nb_cols &&
+         i < 2 * (int)g->nb_rows && j < 2 * (int)g->nb_cols;
+}
+
+/* ************************************************************************** */
+
+static bool _next_plain(cgame g, int *pi, int *pj, direction dir) {
+  int i = *pi + i_offset[dir];
+  int j = *pj + j_offset[dir];
+  if (!_inside_plain(g, i, j)) return false;
+  *pi = i;
+  *pj = j;
+  return true;
+}
+
+/* ************************************************************************** */
+
+static bool _next_wrapping(cgame g, int *pi, int *pj, direction dir) {
+  *pi = _wrap(*pi + i_offset[dir], g->nb_rows);
+  *pj = _wrap(*pj + j_offset[dir], g->nb_cols);
+  return true;
+}
+
+/* ************************************************************************** */
+
+static bool _test_plain(cgame g, int i, int j, square s, uint m) {
+  return _inside_plain(g, i, j) && (SQUARE(g, i, j) & m) == s;
+}
+
+/* ************************************************************************** */
+
+static bool _test_wrapping(cgame g, int i, int j, square s, uint m) {
+  if (!_inside_wrapping(g, i, j)) return false;
+  i = _wrap(i, g->nb_rows);
+  j = _wrap(j, g->nb_cols);
+  return (SQUARE(g, i, j) & m) == s;
+}
+
+/* ************************************************************************** */
+
+/* append the squares of a straight ray of len steps from the index k, up to
+ * the first wall, and return false if there is one */
+static bool _ray_steps(cgame g, long k, long step, uint len, uint *cells,
+                       uint *n) {
+  for (uint l = 0; l < len; l++) {
+    k += step;
+    if (g->squares[k] & S_BLACK) return false;
+    cells[(*n)++] = k;
   }
-  if (i < 0 || j < 0 || i >= (int)g->nb_rows || j >= (int)g->nb_cols)
-    return false;
   return true;
 }
 
 /* ************************************************************************** */
 
+static uint _ray_plain(cgame g, uint i, uint j, direction dir, uint *cells) {
+  // the ray ends at the border: each step is a constant shift of the index
+  long step = i_offset[dir] * (long)g->nb_cols + j_offset[dir];
+  uint n = 0;
+  _ray_steps(g, INDEX(g, i, j), step, _to_border(g, i, j, dir), cells, &n);
+  return n;
+}
+
+/* ************************************************************************** */
+
+static uint _ray_wrapping(cgame g, uint i, uint j, direction dir,
+                          uint *cells) {
+  // the ray goes on from the other side of the board, until the square
+  // before (i,j): this is a second straight ray, shifted by the line length
+  bool vertical = (dir == UP || dir == DOWN);
+  uint dim = vertical ? g->nb_rows : g->nb_cols;
+  long step = i_offset[dir] * (long)g->nb_cols + j_offset[dir];
+  long span = vertical ? (long)g->nb_rows * g->nb_cols : g->nb_cols;
+  uint border = _to_border(g, i, j, dir);
+  long k = INDEX(g, i, j);
+  uint n = 0;
+  if (_ray_steps(g, k, step, border, cells, &n)) {
+    k += border * step - (step > 0 ? span : -span);
+    _ray_steps(g, k, step, dim - 1 - border, cells, &n);
+  }
+  return n;
+}
+
+/* ************************************************************************** */
+
+static const topology plain = {_inside_plain, _next_plain, _test_plain,
+                               _ray_plain};
+static const topology wrapping = {_inside_wrapping, _next_wrapping,
+                                  _test_wrapping, _ray_wrapping};
+
+const topology *_topology(bool wrap) { return wrap ? &wrapping : &plain; }
+
+/* ************************************************************************** */
+
+bool _inside(cgame g, int i, int j) {
+  assert(g);
+  return g->topo->inside(g, i, j);
+}
+
+/* ************************************************************************** */
+
 bool _inside_neigh(cgame g, int i, int j, direction dir) {
   return _inside(g, i + i_offset[dir], j + j_offset[dir]);
 }
@@ -129,25 +258,18 @@ bool _inside_neigh(cgame g, int i, int j, direction dir) {
 bool _next(cgame g, int *pi, int *pj, direction dir) {
   assert(g);
   assert(pi && pj);
-  int i = *pi;
-  int j = *pj;
-  assert(i >= 0 && j >= 0 && i < (int)g->nb_rows && j < (int)g->nb_cols);
-
-  // move to the next square in a given direction
-  i += i_offset[dir];
-  j += j_offset[dir];
-
-  if (game_is_wrapping(g)) {
-    i = (i + game_nb_rows(g)) % game_nb_rows(g);
-    j = (j + game_nb_cols(g)) % game_nb_cols(g);
-  }
-  if (!_inside(g, i, j)) return false;
+  assert(*pi >= 0 && *pj >= 0);
+  assert(*pi < (int)g->nb_rows && *pj < (int)g->nb_cols);
+  return g->topo->next(g, pi, pj, dir);
+}
 
-  // update square coords
-  *pi = i;
-  *pj = j;
+/* ************************************************************************** */
 
-  return true;
+uint _ray(cgame g, uint i, uint j, direction dir, uint *cells) {
+  assert(g && cells);
+  assert(i < g->nb_rows && j < g->nb_cols);
+  assert(dir >= UP && dir <= RIGHT);
+  return g->topo->ray(g, i, j, dir, cells);
 }
 
 /* ************************************************************************** */
@@ -155,12 +277,7 @@ bool _next(cgame g, int *pi, int *pj, direction dir) {
 bool _test(cgame g, int i, int j, square s, uint m) {
   assert(g);
   assert(s >= S_START && s < S_END);
-  if (game_is_wrapping(g)) {
-    i = (i + game_nb_rows(g)) % game_nb_rows(g);
-    j = (j + game_nb_cols(g)) % game_nb_cols(g);
-  }
-  if (!_inside(g, i, j)) return false;
-  return ((SQUARE(g, i, j) & m) == s);
+  return g->topo->test(g, i, j, s, m);
 }
 
 /* ************************************************************************** */
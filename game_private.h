@@ -10,7 +10,6 @@
 #include <stdbool.h>
 
 #include "game.h"
-#include "queue.h"
 
 /* ************************************************************************** */
 /*                                CONSTANTS                                   */
@@ -31,12 +30,24 @@
  * @details This is an opaque data type.
  */
 struct game_s {
-  uint nb_rows;      /**< number of rows in the game */
-  uint nb_cols;      /**< number of columns in the game */
-  square *squares;   /**< the grid of squares */
-  bool wrapping;     /**< the wrapping option */
-  queue *undo_stack; /**< stack to undo moves */
-  queue *redo_stack; /**< stack to redo moves */
+  uint nb_rows;                   /**< number of rows in the game */
+  uint nb_cols;                   /**< number of columns in the game */
+  square *squares;                /**< the grid of squares */
+  bool owned;                     /**< grid owned, not borrowed by a view */
+  bool wrapping;                  /**< the wrapping option */
+  struct move_s *history;         /**< moves played, undone ones at the end */
+  uint nb_moves;                  /**< number of moves in history */
+  uint cursor;                    /**< number of moves played and not undone */
+  uint capacity;                  /**< allocated size of history */
+  uint synced;                    /**< history prefix kept since last sync */
+  bool cleared;                   /**< history cleared since last sync */
+  struct game_session_s *journal; /**< journal of the history, or NULL */
+  uint *touched;                  /**< squares moved since the flags update */
+  uint nb_touched;                /**< number of touched squares */
+  bool stale;                     /**< flags to be fully recomputed */
+  bool edited;                    /**< flags set by hand, not computed */
+  square *shown;                  /**< squares at the last acknowledgement */
+  const struct topology_s *topo;  /**< kernels of the wrapping option */
 };
 
 /**
@@ -46,6 +57,7 @@ struct game_s {
 struct move_s {
   uint i, j;
   square old, new;
+  bool linked; /**< undone and redone with the previous move */
 };
 
 typedef struct move_s move;
@@ -62,6 +74,22 @@ typedef enum {
   DOWN_RIGHT
 } direction;
 
+/**
+ * @brief Topology kernels.
+ * @details The neighborhood and the rays of a square, specialized for the
+ * boards with and without the wrapping option, so that their loops neither
+ * test the option nor divide. The kernels are chosen at the creation of a
+ * game (see @ref _topology).
+ */
+struct topology_s {
+  bool (*inside)(cgame g, int i, int j);
+  bool (*next)(cgame g, int *pi, int *pj, direction dir);
+  bool (*test)(cgame g, int i, int j, square s, uint m);
+  uint (*ray)(cgame g, uint i, uint j, direction dir, uint *cells);
+};
+
+typedef struct topology_s topology;
+
 /* ************************************************************************** */
 /*                                MACRO                                       */
 /* ************************************************************************** */
@@ -73,20 +101,23 @@ typedef enum {
 #define MAX(x, y) ((x > (y)) ? (x) : (y))
 
 /* ************************************************************************** */
-/*                             STACK ROUTINES                                 */
+/*                            HISTORY ROUTINES                                */
 /* ************************************************************************** */
 
-/** push a move in the stack */
-void _stack_push_move(queue *q, move m);
+/** initialize an empty history */
+void _history_init(game g);
+
+/** push a move at the cursor, dropping the undone moves */
+void _history_push(game g, move m);
 
-/** pop a move from the stack */
-move _stack_pop_move(queue *q);
+/** clear the history */
+void _history_clear(game g);
 
-/** test if the stack is empty */
-bool _stack_is_empty(queue *q);
+/** append the changes of the history to the journal of the game */
+void _journal_append(game g);
 
-/** clear all the stack */
-void _stack_clear(queue *q);
+/** detach the journal of the game, return false if an error occurred */
+bool _journal_close(game g);
 
 /* ************************************************************************** */
 /*                          GAME PRIVATE ROUTINES                             */
@@ -117,10 +148,62 @@ int _str2square(char c);
 
 bool _check_square(square s);
 
+/**
+ * @brief make a view own its grid before a mutation
+ * @details A view borrows the grid of its creator: this copies it into a
+ * private grid the first time the game is modified (copy-on-write).
+ *
+ * @param g the game
+ */
+void _own_squares(game g);
+
+/**
+ * @brief update the flags after a move at (i,j)
+ * @details The flags of the other squares must be up to date before the move.
+ * Only the squares in sight of (i,j) and the walls next to them are updated,
+ * in O((nb_rows+nb_cols)^2) instead of O(nb_rows*nb_cols*(nb_rows+nb_cols))
+ * for game_update_flags().
+ *
+ * @param g the game
+ * @param i row index
+ * @param j column index
+ */
+void _update_flags_around(game g, uint i, uint j);
+
+/**
+ * @brief record that the state of (i,j) has changed
+ * @details The flags are not updated: it is done by @ref _flags_resolve, on
+ * the first query of the flags. The moves are updated one by one with @ref
+ * _update_flags_around, unless a full update is cheaper.
+ *
+ * @param g the game
+ * @param i row index
+ * @param j column index
+ */
+void _flags_touch(game g, uint i, uint j);
+
+/**
+ * @brief bring the flags up to date before reading them
+ * @details This only writes the flags, and is called by the queries of a
+ * constant game: a game must not be queried by several threads at once while
+ * its flags are pending.
+ *
+ * @param g the game
+ */
+void _flags_resolve(cgame g);
+
 /* ************************************************************************** */
 /*                                 NEIGHBORHOOD                               */
 /* ************************************************************************** */
 
+/**
+ * @brief get the topology kernels of the boards
+ *
+ * @param wrapping the wrapping option
+ * @return the kernels for this option
+ */
+const topology *_topology(bool wrapping);
+
 /**
  * @brief test if a given square is inside the board
  *
@@ -157,6 +240,23 @@ bool _next(cgame g, int *pi, int *pj, direction dir);
  */
 bool _inside_neigh(cgame g, int i, int j, direction dir);
 
+/**
+ * @brief get the squares in sight of a given square in a given direction
+ *
+ * @details The squares are those seen from (i,j), up to the first wall,
+ * without (i,j) itself. With the wrapping option, a ray stops before going
+ * back to (i,j).
+ *
+ * @param g the game
+ * @param i row index
+ * @param j column index
+ * @param dir the direction to consider (UP, DOWN, LEFT or RIGHT)
+ * @param cells an array of MAX(nb_rows, nb_cols) indices, receiving the
+ * squares in sight in their order along the ray
+ * @return the number of squares in sight
+ */
+uint _ray(cgame g, uint i, uint j, direction dir, uint *cells);
+
 /**
  * @brief test if a square has a given value
  *
@@ -9,39 +9,69 @@
 #include "game_ext.h"
 #include "game_tools.h"
 
+/* write a game in the text format of game_save */
+static void _fprint_game(FILE *f, cgame g) {
+  size_t len = game_save_mem(g, NULL, 0);
+  char *buf = malloc(len + 1);
+  assert(buf);
+  game_save_mem(g, buf, len + 1);
+  fwrite(buf, 1, len, f);
+  free(buf);
+}
+
 int main(int argc, char *argv[]) {
   if (argc != 3 && argc != 4) {
     fprintf(stderr, "parametre manquant ou en trop\n");
     return EXIT_FAILURE;
   }
-  game g = game_load(argv[2]);
-  if (strcmp(argv[1], "-s") == 0) {
-    if (game_solve(g)) {
-      if (argc == 3) {
-        game_print(g);
-        return EXIT_SUCCESS;
-      } else {
-        game_save(g, argv[3]);
-        return EXIT_SUCCESS;
-      }
-    } else {
-      fprintf(stderr, "Aucune solution trouvé\n");
+  bool solve = (strcmp(argv[1], "-s") == 0);
+  if (!solve && strcmp(argv[1], "-c") != 0) {
+    fprintf(stderr, "-s ou bien -c pour executer game_solve\n");
+    return EXIT_FAILURE;
+  }
+  // the input file may hold several games, solved one after the other
+  game_reader r = game_reader_open(argv[2]);
+  if (!r) {
+    fprintf(stderr, "ERROR: Failed to open the file!\n");
+    return EXIT_FAILURE;
+  }
+  FILE *out = stdout;
+  if (argc == 4) {
+    out = fopen(argv[3], "w");
+    if (!out) {
+      fprintf(stderr, "ERROR: Failed to open the file!\n");
+      game_reader_delete(r);
       return EXIT_FAILURE;
     }
-  } else if (strcmp(argv[1], "-c") == 0) {
-    uint cpt = game_nb_solutions(g);
-    if (argc == 3) {
-      printf("%u\n", cpt);
-      return EXIT_SUCCESS;
+  }
+
+  int status = EXIT_SUCCESS;
+  uint nb_games = 0;
+  game g;
+  while ((g = game_reader_next(r))) {
+    nb_games++;
+    if (!solve) {
+      fprintf(out, "%u\n", game_nb_solutions(g));
+    } else if (game_solve(g)) {
+      if (argc == 3)
+        game_print(g);
+      else
+        _fprint_game(out, g);
     } else {
-      FILE *fichiersol = fopen(argv[3], "w");
-      fprintf(fichiersol, "%u\n", cpt);
-      fclose(fichiersol);
-      return EXIT_SUCCESS;
+      fprintf(stderr, "Aucune solution trouvé\n");
+      status = EXIT_FAILURE;
     }
-  } else {
-    fprintf(stderr, "-s ou bien -c pour executer game_solve\n");
-    return EXIT_FAILURE;
+    game_delete(g);
   }
-  return EXIT_SUCCESS;
-}
\ No newline at end of file
+  if (game_reader_error(r) != GAME_OK) {
+    fprintf(stderr, "ERROR: %s!\n", game_strerror(game_reader_error(r)));
+    status = EXIT_FAILURE;
+  } else if (nb_games == 0) {
+    fprintf(stderr, "ERROR: no game in the file!\n");
+    status = EXIT_FAILURE;
+  }
+
+  if (argc == 4) fclose(out);
+  game_reader_delete(r);
+  return status;
+}
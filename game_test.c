@@ -109,10 +109,38 @@ struct test tests[] = {  // dummy test
     {"undo_redo_some", test_undo_redo_some},
     {"undo_redo_all", test_undo_redo_all},
     {"restart_undo", test_restart_undo},
+    {"new_view", test_new_view},
+    {"play_moves", test_play_moves},
+    {"lazy_flags", test_lazy_flags},
+    {"changed_cells", test_changed_cells},
+    {"export_squares", test_export_squares},
+    {"fast_accessors", test_fast_accessors},
 
     /* fichiers */
     {"game_save", test_game_save},
     {"game_load", test_game_load},
+    {"game_load_ext", test_game_load_ext},
+    {"game_save_mem", test_game_save_mem},
+    {"game_save_ext", test_game_save_ext},
+    {"game_encode", test_game_encode},
+    {"game_pack", test_game_pack},
+    {"game_load_id", test_game_load_id},
+    {"game_reader", test_game_reader},
+    {"game_session", test_game_session},
+    {"game_journal", test_game_journal},
+    {"game_replay", test_game_replay},
+
+    /* solver */
+    {"solve", test_solve},
+    {"nb_solutions", test_nb_solutions},
+    {"solve_from_position", test_solve_from_position},
+    {"hint", test_hint},
+    {"hinter", test_hinter},
+    {"grade", test_grade},
+    {"random", test_random},
+    {"minimize_clues", test_minimize_clues},
+    {"transform", test_transform},
+    {"cache", test_cache},
 
     // end
     {NULL, NULL}};
@@ -65,6 +65,12 @@ int test_undo_one(void);
 int test_undo_redo_some(void);
 int test_undo_redo_all(void);
 int test_restart_undo(void);
+int test_new_view(void);
+int test_play_moves(void);
+int test_lazy_flags(void);
+int test_changed_cells(void);
+int test_export_squares(void);
+int test_fast_accessors(void);
 
 /* ************************************************************************** */
 /*                              EXT TESTS (FICHIER)                           */
@@ -72,5 +78,30 @@ int test_restart_undo(void);
 
 int test_game_save(void);
 int test_game_load(void);
+int test_game_load_ext(void);
+int test_game_save_mem(void);
+int test_game_save_ext(void);
+int test_game_encode(void);
+int test_game_pack(void);
+int test_game_load_id(void);
+int test_game_reader(void);
+int test_game_session(void);
+int test_game_journal(void);
+int test_game_replay(void);
+
+/* ************************************************************************** */
+/*                              TOOLS TESTS (SOLVER)                          */
+/* ************************************************************************** */
+
+int test_solve(void);
+int test_nb_solutions(void);
+int test_solve_from_position(void);
+int test_hint(void);
+int test_hinter(void);
+int test_grade(void);
+int test_random(void);
+int test_minimize_clues(void);
+int test_transform(void);
+int test_cache(void);
 
 #endif  // __GAME_TEST_H__
@@ -79,3 +79,548 @@ int test_game_save() {
   fclose(fic);
   return EXIT_SUCCESS;
 }
+
+/* ************************************************************************** */
+
+static bool write_file(char *filename, char *content) {
+  FILE *f = fopen(filename, "w");
+  if (!f) return false;
+  fputs(content, f);
+  fclose(f);
+  return true;
+}
+
+/* ************************************************************************** */
+
+int test_game_load_ext() {
+  // multi-digit dimensions and DOS line endings
+  game g0 = game_new_empty_ext(12, 15, true);
+  game_set_square(g0, 11, 14, S_BLACK2);
+  game_play_move(g0, 10, 3, S_LIGHTBULB);
+  game_save(g0, "test2.txt");
+  game g1 = NULL;
+  bool test0 = game_load_ext("test2.txt", &g1) == GAME_OK;
+  test0 = test0 && game_equal(g0, g1);
+  game_delete(g0);
+  if (g1) game_delete(g1);
+  game g2 = NULL;
+  bool test1 = write_file("test2.txt", "1 3 0\r\nb*1\r\n") &&
+               game_load_ext("test2.txt", &g2) == GAME_OK &&
+               game_is_lightbulb(g2, 0, 1) && !game_has_error(g2, 0, 2);
+  if (g2) game_delete(g2);
+
+  // errors: the game is left untouched
+  game g3 = NULL;
+  bool test2 = game_load_ext("no_such_file.txt", &g3) == GAME_ERR_IO;
+  test2 = test2 && game_load_ext(NULL, &g3) == GAME_ERR_PARAM;
+  char *bad[] = {"",          "2 2\nbb\nbb\n", "2 2 0\nbb\nb\n",
+                 "2 2 0\nbb\nbx\n", "2 2 2\nbb\nbb\n", "0 2 0\n",
+                 "2 2 0\nbbb\nb\n", "99999999999 1 0\nb\n"};
+  for (uint k = 0; k < sizeof(bad) / sizeof(bad[0]); k++)
+    test2 = test2 && write_file("test2.txt", bad[k]) &&
+            game_load_ext("test2.txt", &g3) == GAME_ERR_FORMAT;
+  test2 = test2 && g3 == NULL && game_load("no_such_file.txt") == NULL;
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_game_save_mem() {
+  char expected[] = "1 3 1\n*-2\n";
+  game g0 = game_new_empty_ext(1, 3, true);
+  game_set_square(g0, 0, 2, S_BLACK2);
+  game_play_move(g0, 0, 0, S_LIGHTBULB);
+  game_play_move(g0, 0, 1, S_MARK);
+
+  // too small: nothing written
+  char buf[32] = "unchanged";
+  bool test0 = game_save_mem(g0, NULL, 0) == strlen(expected);
+  test0 = test0 && game_save_mem(g0, buf, strlen(expected)) == strlen(expected);
+  test0 = test0 && strcmp(buf, "unchanged") == 0;
+
+  // round trip, without null character
+  bool test1 = game_save_mem(g0, buf, sizeof(buf)) == strlen(expected);
+  test1 = test1 && strcmp(buf, expected) == 0;
+  game g1 = game_load_mem(buf, strlen(buf));
+  test1 = test1 && g1 && game_equal(g0, g1);
+  if (g1) game_delete(g1);
+  bool test2 = game_load_mem(buf, strlen(buf) - 3) == NULL;
+  test2 = test2 && game_load_mem(NULL, 0) == NULL;
+  game_delete(g0);
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_game_save_ext() {
+  game g0 = game_default();
+  game_play_move(g0, 0, 0, S_LIGHTBULB);
+
+  // atomic save over an existing file, no temporary file left
+  bool test0 = write_file("test3.txt", "old content");
+  test0 = test0 && game_save_ext(g0, "test3.txt", true) == GAME_OK;
+  game g1 = game_load("test3.txt");
+  test0 = test0 && g1 && game_equal(g0, g1);
+  if (g1) game_delete(g1);
+  FILE *f = fopen("test3.txt.tmp", "r");
+  test0 = test0 && f == NULL;
+  if (f) fclose(f);
+  test0 = test0 && game_save_ext(g0, "./test3.txt", true) == GAME_OK;
+
+  // plain save, and errors
+  bool test1 = game_save_ext(g0, "test3.txt", false) == GAME_OK;
+  test1 = test1 && game_save_ext(g0, "no_dir/test3.txt", true) == GAME_ERR_IO;
+  test1 = test1 && game_save_ext(g0, "no_dir/test3.txt", false) == GAME_ERR_IO;
+  test1 = test1 && game_save_ext(NULL, "test3.txt", false) == GAME_ERR_PARAM;
+  game_delete(g0);
+
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+static bool check_codec(game g) {
+  // text and binary formats give the same game
+  char text[1024];
+  size_t len = game_save_mem(g, text, sizeof(text));
+  game g1 = game_load_mem(text, len);
+  uint8_t bin[1024];
+  size_t size = game_encode(g1, bin, sizeof(bin));
+  game g2 = game_decode(bin, size);
+  bool ok = g1 && g2 && size <= sizeof(bin) && game_equal(g, g2);
+  if (g1) game_delete(g1);
+  if (g2) game_delete(g2);
+  return ok;
+}
+
+/* ************************************************************************** */
+
+int test_game_encode() {
+  // nibble-packed and run-length encoded games
+  game g0 = game_default_solution();
+  game_play_move(g0, 2, 2, S_MARK);
+  game g1 = game_random_ext(15, 15, true, 45, false, 1);
+  game g2 = game_new_empty_ext(40, 3, false);
+  game_set_square(g2, 39, 2, S_BLACKU);
+  bool test0 = check_codec(g0) && check_codec(g1) && check_codec(g2);
+  test0 = test0 && game_encode(g2, NULL, 0) < 18 + 60;
+  game_delete(g1);
+  game_delete(g2);
+
+  // too small: nothing written
+  uint8_t buf[64] = {0};
+  size_t size = game_encode(g0, NULL, 0);
+  bool test1 = size == 18 + 25 && game_encode(g0, buf, size - 1) == size;
+  test1 = test1 && buf[0] == 0 && game_encode(g0, buf, size) == size;
+  game_delete(g0);
+
+  // truncated, corrupted or unknown data
+  game g3 = game_decode(buf, size - 1);
+  bool test2 = g3 == NULL && game_decode(NULL, 0) == NULL;
+  for (size_t k = 0; k < size; k++) {
+    buf[k] ^= 0x10;
+    game g4 = game_decode(buf, size);
+    test2 = test2 && g4 == NULL;
+    if (g4) game_delete(g4);
+    buf[k] ^= 0x10;
+  }
+  game g5 = game_decode(buf, size);
+  test2 = test2 && g5 != NULL;
+  if (g5) game_delete(g5);
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_game_pack() {
+  game g[3] = {game_default(), game_random_ext(15, 15, true, 45, false, 2),
+               game_new_empty_ext(2, 2, true)};
+  bool test0 = game_pack_write("test4.lup", (const cgame *)g, 3) == GAME_OK;
+
+  // random access, in any order
+  game_pack pack = game_pack_open("test4.lup");
+  test0 = test0 && pack && game_pack_size(pack) == 3;
+  for (int k = 2; pack && k >= 0; k--) {
+    game gk = game_pack_get(pack, k);
+    test0 = test0 && gk && game_equal(gk, g[k]);
+    if (gk) game_delete(gk);
+  }
+
+  // into an existing game of the same size, left unchanged otherwise
+  game g3 = game_new_empty_ext(7, 7, false);
+  game_play_move(g3, 0, 0, S_LIGHTBULB);
+  bool test2 = pack && game_pack_get_into(pack, 0, g3);
+  game_undo(g3);  // no history left
+  test2 = test2 && game_equal(g3, g[0]);
+  game_play_move(g3, 0, 0, S_LIGHTBULB);
+  test2 = test2 && pack && !game_pack_get_into(pack, 1, g3);
+  test2 = test2 && game_is_lightbulb(g3, 0, 0) && game_is_lighted(g3, 0, 1);
+  game_delete(g3);
+  game_pack_close(pack);
+  for (uint k = 0; k < 3; k++) game_delete(g[k]);
+
+  // empty pack, and errors
+  bool test1 = game_pack_write("test4.lup", NULL, 0) == GAME_OK;
+  game_pack empty = game_pack_open("test4.lup");
+  test1 = test1 && empty && game_pack_size(empty) == 0;
+  game_pack_close(empty);
+  test1 = test1 && game_pack_open("no_such_file.lup") == NULL;
+  FILE *f = fopen("test4.lup", "wb");  // truncated index
+  test1 = test1 && f && fwrite("LUPK\1\0\0\0\5\0\0\0", 1, 12, f) == 12;
+  if (f) fclose(f);
+  test1 = test1 && game_pack_open("test4.lup") == NULL;
+  test1 = test1 && write_file("test4.lup", "1 1 0\nb\n") &&
+          game_pack_open("test4.lup") == NULL;
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_game_load_id() {
+  // the default game, from Simon Tatham's collection
+  char id[] = "7x7:b1f2iB2g1Bi2fBb";
+  game g0 = game_load_id(id, strlen(id));
+  game g1 = game_default();
+  game_update_flags(g1);
+  bool test0 = g0 && game_equal(g0, g1);
+  char buf[64];
+  test0 = test0 && game_save_id(g0, buf, sizeof(buf)) == strlen(id);
+  test0 = test0 && strcmp(buf, id) == 0;
+  test0 = test0 && game_save_id(g0, buf, strlen(id)) == strlen(id);
+  game_delete(g1);
+
+  // player moves are dropped, long runs, wrapping and end of line
+  game_play_move(g0, 0, 0, S_LIGHTBULB);
+  test0 = test0 && game_save_id(g0, buf, sizeof(buf)) == strlen(id);
+  game_delete(g0);
+  game g2 = game_new_empty_ext(2, 20, true);
+  game_set_square(g2, 1, 19, S_BLACK0);
+  bool test1 = game_save_id(g2, buf, sizeof(buf)) == 9;
+  test1 = test1 && strcmp(buf, "20x2w:zm0") == 0;
+  strcat(buf, "\nnext line");
+  game g3 = game_load_id(buf, strlen(buf));
+  test1 = test1 && g3 && game_equal(g2, g3);
+  game_delete(g2);
+  if (g3) game_delete(g3);
+
+  // errors
+  char *bad[] = {"",        "7x7",     "7x7:",     "7y7:g",  "0x1:",
+                 "2x1:c",   "2x1:a",   "2x1:5a",   "2x1:bB", "2x1:aC",
+                 "2x1x:b",  "2x1:a a"};
+  bool test2 = game_load_id(NULL, 0) == NULL;
+  for (uint k = 0; k < sizeof(bad) / sizeof(bad[0]); k++)
+    test2 = test2 && game_load_id(bad[k], strlen(bad[k])) == NULL;
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_game_reader() {
+  // a stream mixing all formats
+  game g[4] = {game_default(), game_random_ext(15, 15, true, 45, false, 3),
+               game_new_empty_ext(1, 1, false), game_default_solution()};
+  FILE *f = fopen("test5.txt", "wb");
+  bool test0 = (f != NULL);
+  char text[1024];
+  uint8_t bin[1024];
+  for (uint k = 0; f && k < 4; k++) {
+    if (k == 1) {  // binary
+      size_t len = game_encode(g[k], bin, sizeof(bin));
+      fwrite(bin, 1, len, f);
+    } else if (k == 2) {  // puzzle ID
+      size_t len = game_save_id(g[k], text, sizeof(text));
+      fwrite(text, 1, len, f);
+      fputs("\n\n", f);
+    } else {  // text, the last one without end of line
+      size_t len = game_save_mem(g[k], text, sizeof(text));
+      fwrite(text, 1, k == 3 ? len - 1 : len, f);
+    }
+  }
+  if (f) fclose(f);
+
+  game_reader r = game_reader_open("test5.txt");
+  test0 = test0 && r != NULL;
+  for (uint k = 0; r && k < 4; k++) {
+    game gk = game_reader_next(r);
+    test0 = test0 && gk && game_equal(gk, g[k]);
+    if (gk) game_delete(gk);
+  }
+  test0 = test0 && r && game_reader_next(r) == NULL;
+  test0 = test0 && r && game_reader_error(r) == GAME_OK;
+  game_reader_delete(r);
+  for (uint k = 0; k < 4; k++) game_delete(g[k]);
+
+  // errors stop the reader
+  bool test1 = write_file("test5.txt", "1 1 0\nb\n2 2 0\nbb\n") &&
+               (r = game_reader_open("test5.txt")) != NULL;
+  game g0 = test1 ? game_reader_next(r) : NULL;
+  test1 = test1 && g0 && game_reader_next(r) == NULL;
+  test1 = test1 && game_reader_error(r) == GAME_ERR_FORMAT;
+  if (g0) game_delete(g0);
+  game_reader_delete(r);
+  test1 = test1 && game_reader_open("no_such_file.txt") == NULL;
+
+  // a NUL byte is not blank, a binary length that does not fit the size of
+  // the game is not read, nor a line longer than the game allows
+  const char *bad[4] = {
+      "1 1 0\nb\n\0001 1 0\nb\n",
+      "1 1 0\nb\nLUPB\1\0\1\0\1\0\377\377\377\177\0\0\0\0",
+      "1 1 0\nb\n2 2 0\nbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb",
+      "1 1 0\nb\n2x2:aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
+  size_t bad_lens[4] = {17, 26, 0, 0};  // 0: up to the end of the string
+  bool test2 = true;
+  for (uint k = 0; k < 4; k++) {
+    size_t bad_len = bad_lens[k] ? bad_lens[k] : strlen(bad[k]);
+    f = fopen("test5.txt", "wb");
+    test2 = test2 && f && fwrite(bad[k], 1, bad_len, f) == bad_len;
+    if (f) fclose(f);
+    r = game_reader_open("test5.txt");
+    g0 = r ? game_reader_next(r) : NULL;
+    test2 = test2 && g0 && game_reader_next(r) == NULL;
+    test2 = test2 && game_reader_error(r) == GAME_ERR_FORMAT;
+    if (g0) game_delete(g0);
+    game_reader_delete(r);
+  }
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* compare two games and their histories (undone moves included) */
+static bool same_history(game g1, game g2) {
+  bool same = game_equal(g1, g2);
+  for (uint k = 0; k < 20; k++) {
+    game_undo(g1);
+    game_undo(g2);
+    same = same && game_equal(g1, g2);
+  }
+  for (uint k = 0; k < 20; k++) {
+    game_redo(g1);
+    game_redo(g2);
+    same = same && game_equal(g1, g2);
+  }
+  return same;
+}
+
+static long file_size(char *filename) {
+  FILE *f = fopen(filename, "rb");
+  if (!f) return -1;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fclose(f);
+  return size;
+}
+
+int test_game_session() {
+  game g = game_default();
+  game_play_move(g, 0, 0, S_LIGHTBULB);
+  game_play_move(g, 0, 1, S_MARK);
+  game_session s = game_session_create(g, "test6.ses");
+  bool test0 = (s != NULL);
+  game_play_move(g, 1, 1, S_LIGHTBULB);
+  game_undo(g);
+  game_undo(g);
+  test0 = test0 && game_session_sync(s) == GAME_OK;
+  game g1 = game_session_restore("test6.ses");
+  test0 = test0 && g1 && game_equal(g, g1);
+
+  // only the new moves are appended
+  long size = file_size("test6.ses");
+  game_redo(g);
+  game_redo(g);
+  game_play_move(g, 2, 2, S_MARK);
+  test0 = test0 && game_session_sync(s) == GAME_OK;
+  test0 = test0 && file_size("test6.ses") == size + 7 + 5;
+  game g2 = game_session_restore("test6.ses");
+  test0 = test0 && g2 && game_equal(g, g2);
+
+  // a truncated tail is ignored
+  size = file_size("test6.ses");
+  game_undo(g);
+  game_undo(g);
+  game_play_move(g, 5, 5, S_LIGHTBULB);
+  game_play_move(g, 6, 6, S_MARK);
+  test0 = test0 && game_session_sync(s) == GAME_OK;
+  char buf[512];
+  FILE *f = fopen("test6.ses", "rb");
+  size_t len = f ? fread(buf, 1, sizeof(buf), f) : 0;
+  if (f) fclose(f);
+  f = fopen("test6.ses", "wb");
+  if (f) {
+    fwrite(buf, 1, len - 3, f);
+    fclose(f);
+  }
+  game g3 = game_session_restore("test6.ses");
+  test0 = test0 && g2 && g3 && same_history(g2, g3);
+
+  // the full history is restored, after a restart too
+  game g4 = game_session_restore("test6.ses");
+  test0 = test0 && g4 && game_equal(g4, g3);
+  game_session_close(s);
+  s = game_session_create(g, "test6.ses");
+  game g5 = game_session_restore("test6.ses");
+  test0 = test0 && s && g5 && same_history(g, g5);
+  game_restart(g);
+  game_play_move(g, 3, 3, S_MARK);
+  test0 = test0 && game_session_sync(s) == GAME_OK;
+  game g6 = game_session_restore("test6.ses");
+  test0 = test0 && g6 && same_history(g, g6);
+  game_session_close(s);
+
+  // errors
+  bool test1 = write_file("test6.ses", "LUPS") &&
+               game_session_restore("test6.ses") == NULL &&
+               game_session_restore("no_such_file.ses") == NULL;
+
+  game gs[] = {g, g1, g2, g3, g4, g5, g6};
+  for (uint k = 0; k < 7; k++)
+    if (gs[k]) game_delete(gs[k]);
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+int test_game_journal() {
+  game g = game_new_empty_ext(10, 10, true);
+  game_set_square(g, 4, 4, S_BLACK2);
+  bool test0 = game_journal_attach(g, "test7.ses") == GAME_OK;
+  for (uint k = 0; k < 1000; k++) {
+    uint i = (k * 7) % 10, j = (k * 3) % 10;
+    if (i == 4 && j == 4) continue;
+    game_play_move(g, i, j, k % 3 == 0 ? S_LIGHTBULB : S_MARK);
+    if (k % 5 == 0) game_undo(g);
+    if (k % 10 == 0) game_redo(g);
+  }
+  game_undo(g);
+  game g1 = game_session_restore("test7.ses");  // as after a crash
+  test0 = test0 && g1 && same_history(g, g1);
+  game_restart(g);
+  game_play_move(g, 0, 0, S_LIGHTBULB);
+  game g2 = game_session_restore("test7.ses");
+  test0 = test0 && g2 && same_history(g, g2);
+  test0 = test0 && game_journal_detach(g) == GAME_OK;
+  game_play_move(g, 1, 1, S_LIGHTBULB);  // no more journal
+  game g3 = game_session_restore("test7.ses");
+  test0 = test0 && g3 && !game_equal(g, g3);
+
+  // a journal is detached when its game is deleted
+  game g4 = game_default();
+  test0 = test0 && game_journal_attach(g4, "test8.ses") == GAME_OK;
+  game_play_move(g4, 0, 0, S_LIGHTBULB);
+  game g5 = game_copy(g4);
+  game_delete(g4);
+  game g6 = game_session_restore("test8.ses");
+  test0 = test0 && g6 && game_equal(g5, g6);
+
+  // a transaction is restored as a whole
+  game g7 = game_default();
+  game_move batch[] = {{0, 0, S_LIGHTBULB}, {0, 1, S_MARK}};
+  test0 = test0 && game_journal_attach(g7, "test8.ses") == GAME_OK;
+  test0 = test0 && game_play_moves(g7, batch, 2);
+  game g8 = game_session_restore("test8.ses");
+  test0 = test0 && g8 && same_history(g7, g8);
+
+  bool test1 = game_journal_attach(g, "no_such_dir/test7.ses") == GAME_ERR_IO;
+
+  // attached to the file it was restored from, then rotated: the file is
+  // replaced through a temporary one, never truncated
+  game g9 = game_session_restore("test8.ses");
+  bool test2 = g9 && game_journal_attach(g9, "test8.ses") == GAME_OK;
+  game g10 = game_session_restore("test8.ses");
+  test2 = test2 && g10 && same_history(g9, g10);
+  if (g9) game_transform(g9, T_ROTATE_90);
+  game g11 = game_session_restore("test8.ses");
+  test2 = test2 && g11 && same_history(g9, g11);
+  FILE *f = fopen("test8.ses.tmp", "r");
+  test2 = test2 && f == NULL;
+  if (f) fclose(f);
+
+  game gs[] = {g, g1, g2, g3, g5, g6, g7, g8, g9, g10, g11};
+  for (uint k = 0; k < 11; k++)
+    if (gs[k]) game_delete(gs[k]);
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+int test_game_replay() {
+  bool test0 = true;
+  for (uint w = 0; w < 2; w++) {
+    // a game with all kinds of moves, the undone ones are dropped
+    game g = game_random_ext(7, 9, w, 15, false, 42);
+    uint n = 0;
+    game ref[64];  // position after each move
+    ref[n++] = game_copy(g);
+    for (uint k = 0; n < 60; k++) {
+      uint i = (k * 5) % 7, j = (k * 4) % 9;
+      if (game_is_black(g, i, j)) continue;
+      game_play_move(g, i, j, (square[]){S_LIGHTBULB, S_MARK, S_BLANK}[k % 3]);
+      if (k % 7 == 3) {
+        game_undo(g);
+        continue;
+      }
+      ref[n++] = game_copy(g);
+    }
+    test0 = test0 && game_replay_write("test9.rep", g, 8) == GAME_OK;
+    game_replay r = game_replay_open("test9.rep");
+    test0 = test0 && r && game_replay_size(r) == n - 1;
+    test0 = test0 && r && game_equal(game_replay_game(r), ref[0]);
+
+    // step forward and backward, then seek anywhere
+    for (uint k = 1; r && k < n; k++)
+      test0 = test0 && game_replay_next(r) && game_replay_position(r) == k &&
+              game_equal(game_replay_game(r), ref[k]);
+    test0 = test0 && r && !game_replay_next(r);
+    for (uint k = n - 1; r && k > 30; k--)
+      test0 = test0 && game_replay_prev(r) &&
+              game_equal(game_replay_game(r), ref[k - 1]);
+    uint seeks[] = {0, 59, 13, 12, 40, 41, 5, 58, 0};
+    for (uint k = 0; r && k < 9; k++)
+      test0 = test0 && game_replay_seek(r, seeks[k]) &&
+              game_replay_position(r) == seeks[k] &&
+              game_equal(game_replay_game(r), ref[seeks[k]]);
+    test0 = test0 && r && !game_replay_prev(r) && !game_replay_seek(r, n);
+    game_replay_close(r);
+    for (uint k = 0; k < n; k++) game_delete(ref[k]);
+    game_delete(g);
+  }
+
+  // keyframes packed differently: bulbs on a checkerboard, then all blanked
+  game g = game_new_empty_ext(8, 8, false);
+  for (uint i = 0; i < 8; i++)
+    for (uint j = (i % 2); j < 8; j += 2) game_set_square(g, i, j, S_LIGHTBULB);
+  game_update_flags(g);
+  game ref = game_copy(g);
+  for (uint i = 0; i < 8; i++)
+    for (uint j = (i % 2); j < 8; j += 2) game_play_move(g, i, j, S_BLANK);
+  test0 = test0 && game_replay_write("test9.rep", g, 1) == GAME_OK;
+  game_replay r = game_replay_open("test9.rep");
+  test0 = test0 && r && game_replay_size(r) == 32 &&
+          game_equal(game_replay_game(r), ref);
+  test0 = test0 && r && game_replay_seek(r, 32) &&
+          game_equal(game_replay_game(r), g);
+  game_replay_close(r);
+  game_delete(ref);
+  game_delete(g);
+
+  // errors
+  bool test1 = write_file("test9.rep", "LUPR") &&
+               game_replay_open("test9.rep") == NULL &&
+               game_replay_open("no_such_file.rep") == NULL;
+  g = game_default();
+  test1 = test1 && game_replay_write("test9.rep", g, 0) == GAME_ERR_PARAM;
+  game_delete(g);
+
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,471 @@
+/**
+ * @file game_test_tools.c
+ * @brief Game Tests Tools.
+ * @copyright University of Bordeaux. All rights reserved, 2021.
+ *
+ **/
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game.h"
+#include "game_aux.h"
+#include "game_examples.h"
+#include "game_ext.h"
+#include "game_test.h"
+#include "game_tools.h"
+
+/* ************************************************************************** */
+/*                              TOOLS TESTS (SOLVER)                          */
+/* ************************************************************************** */
+
+int test_solve(void) {
+  // default game
+  game g0 = game_default();
+  bool test0 = game_solve(g0);
+  bool test1 = check_game(g0, solution_squares);
+  game_delete(g0);
+
+  // rectangular and wrapping games
+  game g1 = game_new_ext(3, 10, ext_3x10_squares, false);
+  bool test2 = game_solve(g1);
+  test2 = test2 && check_game_ext(g1, 3, 10, sol_3x10_squares, false);
+  game_delete(g1);
+  game g2 = game_new_ext(2, 2, ext_2x2w_squares, true);
+  bool test3 = game_solve(g2);
+  test3 = test3 && check_game_ext(g2, 2, 2, sol_2x2w_squares, true);
+  game_delete(g2);
+
+  // no solution: the game is unchanged
+  game g3 = game_new_empty_ext(1, 3, false);
+  game_set_square(g3, 0, 1, S_BLACK3);
+  game g4 = game_copy(g3);
+  bool test4 = !game_solve(g3) && game_equal(g3, g4);
+  game_delete(g3);
+  game_delete(g4);
+
+  if (test0 && test1 && test2 && test3 && test4) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_nb_solutions(void) {
+  game g0 = game_default();
+  bool test0 = (game_nb_solutions(g0) == 1);
+  game_delete(g0);
+
+  // 2x2 without walls: two diagonal layouts
+  game g1 = game_new_empty_ext(2, 2, false);
+  bool test1 = (game_nb_solutions(g1) == 2);
+  game_delete(g1);
+
+  // 3x3 with wrapping: one light bulb per row and column
+  game g2 = game_new_empty_ext(3, 3, true);
+  bool test2 = (game_nb_solutions(g2) == 6);
+  game_delete(g2);
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_solve_from_position(void) {
+  uint conflicts[DEFAULT_SIZE * DEFAULT_SIZE];
+  uint nb = 0;
+
+  // good moves are completed into the solution, marks are kept
+  game g0 = game_default();
+  game_play_move(g0, 0, 0, S_LIGHTBULB);
+  game_play_move(g0, 6, 6, S_MARK);
+  bool test0 = game_solve_from_position(g0, conflicts, &nb) && nb == 0;
+  bool test1 = game_is_over(g0) && game_is_marked(g0, 6, 6);
+  game_delete(g0);
+
+  // a wrong light bulb far from the others is a conflict on its own
+  game g1 = game_default();
+  game_play_move(g1, 0, 0, S_LIGHTBULB);
+  game_play_move(g1, 3, 3, S_LIGHTBULB);
+  game g2 = game_copy(g1);
+  bool test2 = !game_solve_from_position(g1, conflicts, &nb);
+  bool test3 = (nb == 1 && conflicts[0] == 3 * DEFAULT_SIZE + 3);
+  bool test4 = game_equal(g1, g2);
+  game_delete(g1);
+  game_delete(g2);
+
+  // two marks that are right alone but wrong together
+  game g3 = game_new_empty_ext(2, 2, false);
+  game_play_move(g3, 0, 1, S_MARK);
+  game_play_move(g3, 1, 1, S_MARK);
+  bool test5 = !game_solve_from_position(g3, conflicts, &nb) && nb == 2;
+  game_delete(g3);
+
+  if (test0 && test1 && test2 && test3 && test4 && test5) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_hint(void) {
+  hint h;
+
+  // the wall (2,6) has exactly two free neighbours
+  game g0 = game_default();
+  bool test0 = game_hint(g0, &h) && h.rule == H_WALL_FREE;
+  test0 = test0 && h.s == S_LIGHTBULB && h.i == 1 && h.j == 6;
+  test0 = test0 && h.ri == 2 && h.rj == 6;
+
+  // the wall (0,2) is saturated by the light bulb (0,1)
+  game_play_move(g0, 0, 1, S_LIGHTBULB);
+  bool test1 = game_hint(g0, &h) && h.rule == H_WALL_FULL;
+  test1 = test1 && h.s == S_MARK && h.i == 0 && h.j == 3;
+
+  // no hint on a position with a mistake
+  game_play_move(g0, 0, 0, S_LIGHTBULB);
+  bool test2 = !game_hint(g0, &h) && h.rule == H_NONE;
+  game_delete(g0);
+
+  // following the hints solves the default game
+  game g1 = game_default();
+  while (game_hint(g1, &h)) game_play_move(g1, h.i, h.j, h.s);
+  bool test3 = game_is_over(g1);
+  game_delete(g1);
+
+  if (test0 && test1 && test2 && test3) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+/* the hint of a context is the one of game_hint() */
+static bool _same_hint(game_hinter hc, cgame g) {
+  hint h0, h1;
+  bool ok0 = game_hint(g, &h0), ok1 = game_hinter_next(hc, g, &h1);
+  if (ok0 != ok1 || h0.rule != h1.rule) return false;
+  return !ok0 || (h0.i == h1.i && h0.j == h1.j && h0.s == h1.s &&
+                  h0.ri == h1.ri && h0.rj == h1.rj);
+}
+
+/* ************************************************************************** */
+
+int test_hinter(void) {
+  game_hinter hc = game_hinter_new();
+
+  // following the hints, with undo and redo on the way
+  game g0 = game_default();
+  hint h;
+  bool test0 = _same_hint(hc, g0);
+  while (test0 && game_hinter_next(hc, g0, &h)) {
+    game_play_move(g0, h.i, h.j, h.s);
+    game_undo(g0);
+    test0 = test0 && _same_hint(hc, g0);
+    game_redo(g0);
+    test0 = test0 && _same_hint(hc, g0);
+  }
+  test0 = test0 && game_is_over(g0);
+
+  // a mistake, then the move that made it undone
+  game_restart(g0);
+  game_play_move(g0, 0, 0, S_LIGHTBULB);
+  game_play_move(g0, 0, 1, S_LIGHTBULB);
+  bool test1 = _same_hint(hc, g0) && !game_hinter_next(hc, g0, &h);
+  game_undo(g0);
+  test1 = test1 && _same_hint(hc, g0) && game_hinter_next(hc, g0, &h);
+
+  // the oldest move removed, a light bulb turned into a mark
+  game_play_move(g0, 1, 6, S_LIGHTBULB);
+  game_play_move(g0, 3, 6, S_LIGHTBULB);
+  bool test2 = _same_hint(hc, g0);
+  game_play_move(g0, 0, 0, S_BLANK);
+  test2 = test2 && _same_hint(hc, g0);
+  game_play_move(g0, 1, 6, S_MARK);
+  test2 = test2 && _same_hint(hc, g0);
+
+  // a wall changed, then another game
+  game_set_square(g0, 2, 6, S_BLACKU);
+  bool test3 = _same_hint(hc, g0);
+  game g1 = game_new_empty_ext(3, 4, true);
+  game_set_square(g1, 1, 1, S_BLACK2);
+  test3 = test3 && _same_hint(hc, g1);
+  game_play_move(g1, 0, 1, S_LIGHTBULB);
+  test3 = test3 && _same_hint(hc, g1);
+  game_delete(g0);
+  game_delete(g1);
+
+  game_hinter_delete(hc);
+  if (test0 && test1 && test2 && test3) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_grade(void) {
+  // the default game is solved by deduction only
+  game g0 = game_default();
+  grade r0 = game_grade(g0);
+  bool test0 = r0.solvable && r0.unique && r0.nb_guesses == 0;
+  test0 = test0 && r0.nb_rounds > 0 && r0.nb_moves[H_WALL_FREE] > 0;
+  test0 = test0 && r0.hardest != H_NONE && r0.score > 0;
+  game_delete(g0);
+
+  // without walls, guessing is needed and there are several solutions
+  game g1 = game_new_empty_ext(4, 4, false);
+  grade r1 = game_grade(g1);
+  bool test1 = r1.solvable && !r1.unique && r1.nb_guesses > 0;
+  game_delete(g1);
+
+  // no solution
+  game g2 = game_new_empty_ext(1, 3, false);
+  game_set_square(g2, 0, 1, S_BLACK3);
+  grade r2 = game_grade(g2);
+  bool test2 = !r2.solvable && !r2.unique;
+  game_delete(g2);
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_random(void) {
+  // the same seed gives the same game, with a unique solution
+  game g0 = game_random_ext(7, 7, false, 10, false, 42);
+  game g1 = game_random_ext(7, 7, false, 10, false, 42);
+  bool test0 = g0 && g1 && game_equal(g0, g1);
+  test0 = test0 && game_nb_solutions(g0) == 1 && !game_is_over(g0);
+  game_delete(g0);
+  game_delete(g1);
+
+  // with solution, on a rectangular wrapping grid
+  game g2 = game_random_ext(5, 8, true, 8, true, 7);
+  bool test1 = g2 && game_is_over(g2) && game_is_wrapping(g2);
+  test1 = test1 && game_nb_rows(g2) == 5 && game_nb_cols(g2) == 8;
+  uint nb_walls = 0;
+  for (uint i = 0; g2 && i < 5; i++)
+    for (uint j = 0; j < 8; j++) nb_walls += game_is_black(g2, i, j);
+  test1 = test1 && nb_walls == 8;
+  game_delete(g2);
+
+  // a grid full of walls
+  game g3 = game_random(2, 3, false, 6, false);
+  bool test2 = g3 && game_is_over(g3);
+  game_delete(g3);
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+/* default game with all walls numbered */
+static game _default_numbered(void) {
+  game g = game_default();
+  game sol = game_default_solution();
+  int di[4] = {-1, 1, 0, 0}, dj[4] = {0, 0, -1, 1};
+  for (int i = 0; i < DEFAULT_SIZE; i++)
+    for (int j = 0; j < DEFAULT_SIZE; j++) {
+      if (!game_is_black(g, i, j)) continue;
+      uint n = 0;
+      for (uint k = 0; k < 4; k++) {
+        int ni = i + di[k], nj = j + dj[k];
+        if (ni >= 0 && ni < DEFAULT_SIZE && nj >= 0 && nj < DEFAULT_SIZE)
+          n += game_is_lightbulb(sol, ni, nj);
+      }
+      game_set_square(g, i, j, S_BLACK + n);
+    }
+  game_delete(sol);
+  return g;
+}
+
+/* ************************************************************************** */
+
+int test_minimize_clues(void) {
+  // same result with and without threads, and every number left is needed
+  game g0 = _default_numbered();
+  game g1 = _default_numbered();
+  uint nb0 = game_minimize_clues(g0, 1);
+  uint nb1 = game_minimize_clues(g1, 4);
+  bool test0 = nb0 > 0 && nb0 == nb1 && game_equal(g0, g1);
+  test0 = test0 && game_nb_solutions(g0) == 1;
+  for (uint i = 0; i < DEFAULT_SIZE; i++)
+    for (uint j = 0; j < DEFAULT_SIZE; j++) {
+      if (!game_is_black(g0, i, j) || game_get_black_number(g0, i, j) < 0)
+        continue;
+      game g2 = game_copy(g0);
+      game_set_square(g2, i, j, S_BLACKU);
+      test0 = test0 && game_nb_solutions(g2) > 1;
+      game_delete(g2);
+    }
+  game_delete(g0);
+  game_delete(g1);
+
+  // several solutions: the game is unchanged
+  game g3 = game_new_empty_ext(2, 2, false);
+  game_set_square(g3, 0, 0, S_BLACK1);
+  game g4 = game_copy(g3);
+  bool test1 = game_minimize_clues(g3, 2) == 0 && game_equal(g3, g4);
+  game_delete(g3);
+  game_delete(g4);
+
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+/* ************************************************************************** */
+
+int test_transform(void) {
+  transform inverse[NB_TRANSFORMS] = {
+      T_IDENTITY, T_ROTATE_270, T_ROTATE_180, T_ROTATE_90,
+      T_FLIP_H,   T_FLIP_V,     T_TRANSPOSE,  T_ANTITRANSPOSE};
+  game games[] = {game_default(), game_random_ext(5, 8, true, 10, true, 7)};
+  bool test0 = games[1] != NULL;
+  for (uint k = 0; test0 && k < 2; k++) {
+    game base = games[k];
+    game_update_flags(base);
+    // two moves on the first blank squares, the second one undone
+    uint size = game_nb_rows(base) * game_nb_cols(base), c[2], n = 0;
+    for (uint p = 0; n < 2 && p < size; p++)
+      if (game_is_blank(base, p / game_nb_cols(base), p % game_nb_cols(base)))
+        c[n++] = p;
+    game g[2];
+    for (uint l = 0; l < 2; l++) {
+      g[l] = game_copy(base);
+      for (uint m = 0; m <= l; m++)
+        game_play_move(g[l], c[m] / game_nb_cols(base),
+                       c[m] % game_nb_cols(base), S_MARK);
+    }
+    uint64_t h = game_canonical_hash(g[0]);
+
+    for (uint t = 0; t < NB_TRANSFORMS; t++) {
+      game gt = game_copy(base);
+      game_play_move(gt, c[0] / game_nb_cols(base), c[0] % game_nb_cols(base),
+                     S_MARK);
+      game_play_move(gt, c[1] / game_nb_cols(base), c[1] % game_nb_cols(base),
+                     S_MARK);
+      game_undo(gt);
+      game_transform(gt, t);
+      bool swap = (t == T_ROTATE_90 || t == T_ROTATE_270 ||
+                   t == T_TRANSPOSE || t == T_ANTITRANSPOSE);
+      test0 = test0 && game_nb_rows(gt) == (swap ? game_nb_cols(base)
+                                                 : game_nb_rows(base));
+      test0 = test0 && game_canonical_hash(gt) == h;
+      // the history is transformed as well
+      game_undo(gt);
+      game_transform(gt, inverse[t]);
+      test0 = test0 && game_equal(gt, base);
+      game_redo(gt);
+      game_redo(gt);
+      test0 = test0 && game_equal(gt, g[1]);
+      game_delete(gt);
+    }
+    game_delete(g[0]);
+    game_delete(g[1]);
+  }
+
+  // rotating 4 times gives the same game
+  game g = game_copy(games[0]);
+  for (uint k = 0; k < 4; k++) game_transform(g, T_ROTATE_90);
+  test0 = test0 && game_equal(g, games[0]);
+  // a different game has a different hash
+  game_set_square(g, 6, 6, S_BLACKU);
+  bool test1 = game_canonical_hash(g) != game_canonical_hash(games[0]);
+  game_delete(g);
+  for (uint k = 0; k < 2; k++)
+    if (games[k]) game_delete(games[k]);
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+typedef struct {
+  game* games;
+  uint nb_games;
+  uint* counts;
+} cache_job;
+
+static void* count_solutions(void* arg) {
+  cache_job* job = arg;
+  for (uint k = 0; k < job->nb_games; k++)
+    job->counts[k] = game_nb_solutions(job->games[k]);
+  return NULL;
+}
+
+int test_cache(void) {
+  remove("test_cache.bin");
+  bool test0 = game_cache_open("test_cache.bin", 100) == GAME_OK;
+
+  // every image of a cached puzzle gets the same solution
+  game g = game_default();
+  test0 = test0 && game_nb_solutions(g) == 1;
+  for (uint t = 0; t < NB_TRANSFORMS; t++) {
+    game gt = game_copy(g);
+    game_transform(gt, t);
+    game sol = game_default_solution();
+    game_transform(sol, t);
+    test0 = test0 && game_solve(gt) && game_equal(gt, sol);
+    test0 = test0 && game_nb_solutions(gt) == 1;
+    game_delete(gt);
+    game_delete(sol);
+  }
+
+  // no solution, and the game is unchanged
+  game g1 = game_new_empty_ext(1, 2, false);
+  game_set_square(g1, 0, 0, S_BLACK2);
+  game_update_flags(g1);
+  game g2 = game_copy(g1);
+  test0 = test0 && !game_solve(g1) && !game_solve(g1) && game_equal(g1, g2);
+  test0 = test0 && game_nb_solutions(g1) == 0;
+
+  // the cache is shared by threads, and kept in the file
+  game games[8];
+  uint counts[8], expected[8];
+  game_cache_close();
+  for (uint k = 0; k < 8; k++) {
+    games[k] = game_new_empty_ext(3, 4, k % 2);
+    game_set_square(games[k], k % 3, k % 4, S_BLACK1);
+    expected[k] = game_nb_solutions(games[k]);  // without the cache
+  }
+  test0 = test0 && game_cache_open("test_cache.bin", 0) == GAME_OK;
+  pthread_t threads[4];
+  cache_job jobs[4];
+  for (uint t = 0; t < 4; t++) {
+    jobs[t] = (cache_job){games, 8, counts};
+    if (t > 0) jobs[t].counts = malloc(8 * sizeof(uint));
+    pthread_create(&threads[t], NULL, count_solutions, &jobs[t]);
+  }
+  for (uint t = 0; t < 4; t++) {
+    pthread_join(threads[t], NULL);
+    for (uint k = 0; k < 8; k++)
+      test0 = test0 && jobs[t].counts[k] == expected[k];
+    if (t > 0) free(jobs[t].counts);
+  }
+  game_cache_close();
+  test0 = test0 && game_cache_open("test_cache.bin", 0) == GAME_OK;
+  for (uint k = 0; k < 8; k++)
+    test0 = test0 && game_nb_solutions(games[k]) == expected[k];
+  game_cache_close();
+
+  // errors
+  FILE* f = fopen("test_cache.bin", "w");
+  if (f) {
+    fputs("not a cache", f);
+    fclose(f);
+  }
+  bool test1 = game_cache_open("test_cache.bin", 0) == GAME_ERR_FORMAT;
+  test1 = test1 && game_cache_open("no_such_dir/cache.bin", 0) == GAME_ERR_IO;
+  test1 = test1 && game_nb_solutions(g) == 1;  // no cache
+
+  for (uint k = 0; k < 8; k++) game_delete(games[k]);
+  game_delete(g);
+  game_delete(g1);
+  game_delete(g2);
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
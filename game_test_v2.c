@@ -14,6 +14,7 @@
 #include "game_aux.h"
 #include "game_examples.h"
 #include "game_ext.h"
+#include "game_fast.h"
 #include "game_test.h"
 
 /* ************************************************************************** */
@@ -318,3 +319,256 @@ int test_restart_undo(void) {
 }
 
 /* ************************************************************************** */
+
+int test_new_view(void) {
+  // queries run on the borrowed squares
+  uint size = DEFAULT_SIZE * DEFAULT_SIZE;
+  square sol[DEFAULT_SIZE * DEFAULT_SIZE];
+  memcpy(sol, solution_squares, sizeof(sol));
+  game g0 = game_new_view(DEFAULT_SIZE, DEFAULT_SIZE, sol, false);
+  bool test0 = check_game(g0, solution_squares) && game_is_over(g0);
+
+  // the first move copies the squares, which are left unchanged
+  game_play_move(g0, 0, 0, S_BLANK);
+  bool test1 = !game_is_over(g0) && game_is_blank(g0, 0, 0);
+  test1 = test1 && memcmp(sol, solution_squares, sizeof(sol)) == 0;
+  game_undo(g0);
+  test1 = test1 && check_game(g0, solution_squares);
+
+  // rebinding on another grid clears the history
+  square def[DEFAULT_SIZE * DEFAULT_SIZE];
+  memcpy(def, default_squares, size * sizeof(square));
+  game_rebind_view(g0, def);
+  game_undo(g0);
+  bool test2 = check_game(g0, default_squares) && !game_is_over(g0);
+  game_rebind_view(g0, sol);
+  game_restart(g0);
+  test2 = test2 && check_game(g0, default_squares);
+  test2 = test2 && memcmp(sol, solution_squares, sizeof(sol)) == 0;
+  game_delete(g0);
+
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+/* ************************************************************************** */
+
+int test_play_moves(void) {
+  game_move moves[] = {{0, 0, S_LIGHTBULB},
+                       {0, 1, S_MARK},
+                       {1, 1, S_LIGHTBULB},
+                       {0, 1, S_BLANK}};
+  game g0 = game_default();
+  game g1 = game_default();
+  game_update_flags(g0);
+  game_update_flags(g1);
+  game_play_move(g0, 6, 6, S_MARK);
+  game_play_move(g1, 6, 6, S_MARK);
+  game ref = game_copy(g0);
+
+  // same result as one move at a time, undone and redone at once
+  bool test0 = game_play_moves(g0, moves, 4);
+  for (uint k = 0; k < 4; k++)
+    game_play_move(g1, moves[k].i, moves[k].j, moves[k].s);
+  test0 = test0 && game_equal(g0, g1);
+  game_undo(g0);
+  test0 = test0 && game_equal(g0, ref);
+  game_redo(g0);
+  test0 = test0 && game_equal(g0, g1);
+  game_undo(g0);
+  game_undo(g0);
+  game_redo(g0);
+  test0 = test0 && game_equal(g0, ref);
+
+  // a whole solution at once
+  game g2 = game_default();
+  game sol = game_default_solution();
+  game_move all[49];
+  uint n = 0;
+  for (uint i = 0; i < 7; i++)
+    for (uint j = 0; j < 7; j++)
+      if (game_is_lightbulb(sol, i, j))
+        all[n++] = (game_move){i, j, S_LIGHTBULB};
+  test0 = test0 && game_play_moves(g2, all, n) && game_is_over(g2);
+  test0 = test0 && game_equal(g2, sol);
+
+  // an illegal move: nothing is played
+  game_move bad[] = {{0, 0, S_MARK}, {1, 2, S_LIGHTBULB}};  // (1,2) is a wall
+  game g3 = game_copy(g0);
+  bool test1 = !game_play_moves(g0, bad, 2) && game_equal(g0, g3);
+  test1 = test1 && game_play_moves(g0, NULL, 0) && game_equal(g0, g3);
+
+  game_delete(g0);
+  game_delete(g1);
+  game_delete(g2);
+  game_delete(g3);
+  game_delete(ref);
+  game_delete(sol);
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_lazy_flags(void) {
+  // the flags of a burst of moves, computed at the first query
+  game g0 = game_default();
+  game sol = game_default_solution();
+  game_update_flags(g0);
+  game_play_move(g0, 0, 0, S_LIGHTBULB);
+  bool test0 = game_is_lighted(g0, 0, 1) && !game_is_lighted(g0, 1, 1);
+  for (uint i = 0; i < 7; i++)
+    for (uint j = 0; j < 7; j++) {
+      if (game_is_black(g0, i, j)) continue;
+      game_play_move(g0, i, j, S_MARK);
+      game_play_move(g0, i, j, game_get_state(sol, i, j));
+    }
+  test0 = test0 && game_is_over(g0) && game_equal(g0, sol);
+  game g1 = game_copy(g0);
+  for (uint k = 0; k < 10; k++) game_undo(g0);  // back to no bulb at (6,1)
+  test0 = test0 && !game_is_over(g0) && !game_is_lighted(g0, 6, 1);
+  for (uint k = 0; k < 10; k++) game_redo(g0);
+  test0 = test0 && game_equal(g0, g1);
+
+  // the flags set by hand are kept until the next update or move
+  game g2 = game_default();
+  game_play_move(g2, 0, 0, S_LIGHTBULB);
+  game_set_square(g2, 0, 1, S_BLANK);
+  bool test1 = game_is_lighted(g2, 0, 0) && !game_is_lighted(g2, 0, 1);
+  game_set_square(g2, 1, 0, S_BLANK | F_ERROR);
+  test1 = test1 && game_get_flags(g2, 1, 0) == F_ERROR;
+  game_update_flags(g2);
+  game_update_flags(g2);
+  test1 = test1 && game_get_flags(g2, 1, 0) == F_LIGHTED;
+  test1 = test1 && game_get_square(g2, 0, 1) == (S_BLANK | F_LIGHTED);
+  game_set_square(g2, 0, 1, S_BLANK);
+  game_play_move(g2, 6, 6, S_MARK);
+  test1 = test1 && game_is_lighted(g2, 0, 1);
+  game_restart(g2);
+  test1 = test1 && !game_is_lighted(g2, 0, 0);
+
+  // a copy computes the pending flags without writing its source
+  game_update_flags(g2);  // computed, no longer set by hand
+  test1 = test1 && !game_is_lighted(g2, 0, 1);
+  game_play_move(g2, 0, 0, S_LIGHTBULB);
+  game g3 = game_copy(g2);
+  bool test2 = g2->nb_touched == 1 && g3->nb_touched == 0 && !g3->stale;
+  test2 = test2 && (g3->squares[1] & F_LIGHTED) && game_equal(g2, g3);
+  game_update_flags(g2);
+  game g4 = game_copy(g2);
+  test2 = test2 && g2->stale && !g4->stale && game_equal(g2, g4);
+
+  game_delete(g0);
+  game_delete(g1);
+  game_delete(g2);
+  game_delete(g3);
+  game_delete(g4);
+  game_delete(sol);
+  if (test0 && test1 && test2) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_changed_cells(void) {
+  game g = game_default();
+  uint cells[49];
+  bool test0 = game_changed_cells(g, cells, 49) == 49 && cells[48] == 48;
+  game_ack_changes(g);
+  test0 = test0 && game_changed_cells(g, NULL, 0) == 0;
+
+  // the squares of changed state or flags
+  game_play_move(g, 0, 0, S_MARK);
+  test0 = test0 && game_changed_cells(g, cells, 49) == 1 && cells[0] == 0;
+  game_ack_changes(g);
+  game_play_move(g, 0, 0, S_LIGHTBULB);  // lights (0,1) and (1..3,0)
+  uint lighted[] = {0, 1, 7, 14, 21};
+  test0 = test0 && game_changed_cells(g, cells, 49) == 5;
+  for (uint k = 0; k < 5; k++) test0 = test0 && cells[k] == lighted[k];
+  test0 = test0 && game_changed_cells(g, cells, 2) == 5 && cells[1] == 1;
+
+  // a change undone before the acknowledgement is no change
+  game_undo(g);
+  bool test1 = game_changed_cells(g, cells, 49) == 0;
+  game_restart(g);
+  test1 = test1 && game_changed_cells(g, cells, 49) == 1 && cells[0] == 0;
+  game_ack_changes(g);
+  game g2 = game_copy(g);
+  test1 = test1 && game_changed_cells(g2, NULL, 0) == 49;
+
+  game_delete(g);
+  game_delete(g2);
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_export_squares(void) {
+  game g = game_default();
+  game_play_move(g, 0, 0, S_LIGHTBULB);
+  game_play_move(g, 0, 1, S_LIGHTBULB);
+  uint8_t all[49], rows[14];
+  memset(rows, 0xFF, sizeof(rows));
+  game_export_squares(g, all);
+  game_export_rows(g, 5, 2, rows);
+  bool test0 = all[0] == (S_LIGHTBULB | F_LIGHTED | F_ERROR);
+  for (uint i = 0; i < 7; i++)
+    for (uint j = 0; j < 7; j++) {
+      test0 = test0 && all[i * 7 + j] == game_get_square(g, i, j);
+      if (i >= 5) test0 = test0 && rows[(i - 5) * 7 + j] == all[i * 7 + j];
+    }
+  game_export_rows(g, 7, 0, NULL);
+
+  // the squares of a rectangular game, row after row
+  game g2 = game_new_empty_ext(2, 3, false);
+  game_set_square(g2, 1, 0, S_BLACK2);
+  uint8_t small[6];
+  game_export_squares(g2, small);
+  bool test1 = small[3] == S_BLACK2 && small[0] == S_BLANK;
+  game_export_rows(g2, 1, 1, small);
+  test1 = test1 && small[0] == S_BLACK2 && small[2] == S_BLANK;
+
+  game_delete(g);
+  game_delete(g2);
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
+
+/* ************************************************************************** */
+
+int test_fast_accessors(void) {
+  game g = game_default();
+  game_play_move(g, 0, 0, S_LIGHTBULB);
+  game_play_move(g, 0, 1, S_LIGHTBULB);  // pending flags, with an error
+  game_play_move(g, 6, 6, S_MARK);
+  bool test0 = true;
+  uint n = 0;
+  GAME_FOREACH(g, i, j) {
+    test0 = test0 && game_fast_square(g, i, j) == game_get_square(g, i, j);
+    test0 = test0 && game_fast_state(g, i, j) == game_get_state(g, i, j);
+    test0 = test0 && game_fast_flags(g, i, j) == game_get_flags(g, i, j);
+    test0 = test0 && game_fast_is_blank(g, i, j) == game_is_blank(g, i, j);
+    test0 = test0 &&
+            game_fast_is_lightbulb(g, i, j) == game_is_lightbulb(g, i, j);
+    test0 = test0 && game_fast_is_black(g, i, j) == game_is_black(g, i, j);
+    test0 = test0 && game_fast_is_marked(g, i, j) == game_is_marked(g, i, j);
+    test0 = test0 && game_fast_is_lighted(g, i, j) == game_is_lighted(g, i, j);
+    test0 = test0 && game_fast_has_error(g, i, j) == game_has_error(g, i, j);
+    if (game_is_black(g, i, j))
+      test0 = test0 && game_fast_black_number(g, i, j) ==
+                           game_get_black_number(g, i, j);
+    n++;
+  }
+  test0 = test0 && n == 49;
+
+  // the flags are resolved by the unchecked accessors too
+  game_play_move(g, 0, 1, S_BLANK);
+  bool test1 = !game_fast_has_error(g, 0, 0) && game_fast_is_lighted(g, 0, 1);
+
+  game_delete(g);
+  if (test0 && test1) return EXIT_SUCCESS;
+  return EXIT_FAILURE;
+}
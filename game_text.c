@@ -32,7 +32,57 @@ static void game_print_errors(game g) {
 
 /* ************************************************************************** */
 
-static bool game_step(game g) {
+static void game_print_mistakes(cgame g) {
+  uint nb_cols = game_nb_cols(g);
+  uint size = game_nb_rows(g) * nb_cols;
+  uint *conflicts = malloc(size * sizeof(uint));
+  assert(conflicts);
+  uint nb = 0;
+  game gg = game_copy(g);  // keep the player's position untouched
+  if (game_solve_from_position(gg, conflicts, &nb))
+    printf("No mistake so far\n");
+  else if (nb == 0)
+    printf("This game has no solution\n");
+  for (uint k = 0; k < nb; k++) {
+    uint i = conflicts[k] / nb_cols, j = conflicts[k] % nb_cols;
+    if (game_is_lightbulb(g, i, j))
+      printf("Mistake at light bulb (%d,%d)\n", i, j);
+    else
+      printf("Mistake at mark (%d,%d)\n", i, j);
+  }
+  game_delete(gg);
+  free(conflicts);
+}
+
+/* ************************************************************************** */
+
+static void game_print_hint(cgame g, game_hinter hc) {
+  hint h;
+  if (!game_hinter_next(hc, g, &h)) {
+    printf("No hint: check for mistakes, or make a guess\n");
+    return;
+  }
+  if (h.s == S_LIGHTBULB)
+    printf("Hint: put a light bulb at (%d,%d)\n", h.i, h.j);
+  else
+    printf("Hint: put a mark at (%d,%d)\n", h.i, h.j);
+  if (h.rule == H_WALL_FULL)
+    printf("  the wall at (%d,%d) already has all its light bulbs\n", h.ri,
+           h.rj);
+  else if (h.rule == H_WALL_FREE)
+    printf("  the wall at (%d,%d) has just enough free squares around\n",
+           h.ri, h.rj);
+  else if (h.rule == H_SINGLE)
+    printf("  the square (%d,%d) cannot be lit from anywhere else\n", h.ri,
+           h.rj);
+  else if (h.rule == H_EXCLUSION)
+    printf("  a light bulb there would be a dead end for (%d,%d)\n", h.ri,
+           h.rj);
+}
+
+/* ************************************************************************** */
+
+static bool game_step(game g, game_hinter hc) {
   printf("> ? [h for help]\n");
   // <action> [<row> <col>]
   char c = '?';
@@ -50,6 +100,9 @@ static bool game_step(game g) {
     printf("- press 'l <i> <j>' to put a light bulb at square (i,j)\n");
     printf("- press 'm <i> <j>' to put a mark at square (i,j)\n");
     printf("- press 'b <i> <j>' to blank square (i,j)\n");
+    printf("- press 'c' to check for mistakes\n");
+    printf("- press '?' to get a hint\n");
+    printf("- press 'w <file>' to save the game\n");
     printf("- press 'r' to restart\n");
     printf("- press 'z' to undo\n");
     printf("- press 'y' to redo\n");
@@ -63,6 +116,14 @@ static bool game_step(game g) {
     printf("> action: redo\n");
     game_redo(g);
     return true;
+  } else if (c == 'c') {  // check
+    printf("> action: check\n");
+    game_print_mistakes(g);
+    return true;
+  } else if (c == '?') {  // hint
+    printf("> action: hint\n");
+    game_print_hint(g, hc);
+    return true;
   } else if (c == 'r') {  // restart
     printf("> action: restart\n");
     game_restart(g);
@@ -91,9 +152,13 @@ static bool game_step(game g) {
     return true;          // continue to play
   } else if (c == 'w') {  // save
     printf("> action: save a game\n");
-    char fichier[10];
-    // scanf("%s", fichier);
-    game_save(g, fichier);
+    char fichier[256];
+    if (scanf("%255s", fichier) != 1) {
+      printf("Error: invalid user input! 4\n");
+      return true;
+    }
+    game_error err = game_save_ext(g, fichier, true);
+    if (err != GAME_OK) printf("Error: %s!\n", game_strerror(err));
     return true;
   } else {
     printf("Error: invalid user input! 3\n");
@@ -107,25 +172,54 @@ static bool game_step(game g) {
 
 int main(int argc, char *argv[]) {
   game g = NULL;
-  if (argc == 2) {
+  char *journal = NULL;
+  if (argc >= 3 && strcmp(argv[1], "-j") == 0) {  // game_text -j <journal> ...
+    journal = argv[2];
+    argc -= 2;
+    argv += 2;
+    g = game_session_restore(journal);  // resume the game if any
+  }
+  if (g) {
+    printf("> game restored from %s\n", journal);
+  } else if (argc == 2) {
     g = game_load(argv[1]);
+    if (!g) return EXIT_FAILURE;
+  } else if (argc == 3) {  // k-th game of a pack
+    game_pack pack = game_pack_open(argv[1]);
+    uint k = atoi(argv[2]);
+    if (pack && k < game_pack_size(pack)) g = game_pack_get(pack, k);
+    game_pack_close(pack);
+    if (!g) {
+      fprintf(stderr, "ERROR: no game #%u in pack %s!\n", k, argv[1]);
+      return EXIT_FAILURE;
+    }
   } else {
     g = game_default();
   }
   assert(g);
+  if (journal && game_journal_attach(g, journal) != GAME_OK)
+    fprintf(stderr, "ERROR: Failed to open the journal!\n");
   game_print(g);
+  game_ack_changes(g);
+  game_hinter hc = game_hinter_new();  // kept from one hint to the next
   bool win = game_is_over(g);
   bool cont = true;
   while (!win && cont) {
-    cont = game_step(g);
+    cont = game_step(g, hc);
     win = game_is_over(g);
-    if (cont) game_print(g);
+    // the board is printed again only if a square has changed
+    if (cont && game_changed_cells(g, NULL, 0) > 0) {
+      game_print(g);
+      game_ack_changes(g);
+    }
     game_print_errors(g);
   }
-  if (win)
+  if (win) {
     printf("Congratulation, you win :-)\n");
-  else
+    if (journal && game_journal_detach(g) == GAME_OK) remove(journal);
+  } else
     printf("What a shame, you gave up :-(\n");
+  game_hinter_delete(hc);
   game_delete(g);
   return EXIT_SUCCESS;
 }
@@ -1,99 +1,276 @@
+#define _POSIX_C_SOURCE 200809L  // fileno, fsync, mmap
+
 #include "game_tools.h"
 
+#include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "game.h"
 #include "game_aux.h"
 #include "game_ext.h"
 #include "game_private.h"
+#include "solver.h"
 
-game game_load(char* filename) {
-  if (!filename) {
-    fprintf(stderr, "ERROR: Called game_load on an invalid param!\n");
-    exit(EXIT_FAILURE);
-  }
-  FILE* f = fopen(filename, "r");
-  if (f == NULL) {
-    fprintf(stderr, "ERROR: Failed to open the file!\n");
-    exit(EXIT_FAILURE);
-  }
-  uint nb_rows = 0, nb_cols = 0, wrapping = 0;
-  char actual = fgetc(f);
-  uint cptval = 1;
-  while (actual != '\n') {  // getting nb_rows, nb_cols and wrapping option
-    if (actual == ' ') cptval++;
-    switch (cptval) {
-      case 1:
-        nb_rows = actual - '0';
-        actual = fgetc(f);
-        break;
-      case 2:
-        nb_cols = actual - '0';
-        actual = fgetc(f);
-        break;
-      case 3:
-        wrapping = actual - '0';
-        actual = fgetc(f);
-        break;
-      default:
-        break;
-    }
+/* ************************************************************************** */
+/*                                  FILES                                     */
+/* ************************************************************************** */
+
+static const char* error_messages[] = {
+    [GAME_OK] = "no error",
+    [GAME_ERR_PARAM] = "invalid parameter",
+    [GAME_ERR_IO] = "failed to read or write the file",
+    [GAME_ERR_FORMAT] = "invalid game format",
+    [GAME_ERR_MEMORY] = "out of memory"};
+
+/* ************************************************************************** */
+
+const char* game_strerror(game_error err) {
+  if (err < GAME_OK || err > GAME_ERR_MEMORY) return "unknown error";
+  return error_messages[err];
+}
+
+/* ************************************************************************** */
+
+static void _skip_blanks(const char** p, const char* end) {
+  while (*p < end && (**p == ' ' || **p == '\t' || **p == '\r')) (*p)++;
+}
+
+/* ************************************************************************** */
+
+/* parse an unsigned number, possibly preceded by blanks */
+static bool _parse_uint(const char** p, const char* end, uint* v) {
+  _skip_blanks(p, end);
+  const char* start = *p;
+  uint n = 0;
+  while (*p < end && **p >= '0' && **p <= '9') {
+    uint d = **p - '0';
+    if (n > (UINT_MAX - d) / 10) return false;  // overflow
+    n = n * 10 + d;
+    (*p)++;
   }
-  square* squares = malloc(sizeof(square) * nb_cols * nb_rows);
-  int sq_tmp = 0;
+  *v = n;
+  return *p > start;
+}
+
+/* compute the flags of a game handed to the caller, so that its queries are
+ * pure reads until it is modified (see cgame) */
+static void _flags_compute(game g) {
+  game_update_flags(g);
+  _flags_resolve(g);
+}
+
+/* ************************************************************************** */
+
+/* parse a game in one pass, straight into the grid of a new game */
+static game_error _game_parse(const char* buf, size_t len, game* pg) {
+  const char *p = buf, *end = buf + len;
+  uint nb_rows, nb_cols, wrapping;
+  if (!_parse_uint(&p, end, &nb_rows) || !_parse_uint(&p, end, &nb_cols) ||
+      !_parse_uint(&p, end, &wrapping))
+    return GAME_ERR_FORMAT;
+  _skip_blanks(&p, end);
+  if (p == end || *p++ != '\n') return GAME_ERR_FORMAT;
+  if (nb_rows == 0 || nb_cols == 0 || wrapping > 1) return GAME_ERR_FORMAT;
+  // check the size against the input before allocating anything
+  if ((size_t)nb_rows * nb_cols > (size_t)(end - p)) return GAME_ERR_FORMAT;
+
+  game g = game_new_empty_ext(nb_rows, nb_cols, wrapping);
+  square* sq = g->squares;
   for (uint i = 0; i < nb_rows; i++) {
-    for (uint j = 0; !feof(f) && j < nb_cols; j++) {
-      actual = fgetc(f);
-      if (actual == '\n') actual = fgetc(f);
-      if (actual == 'b') {
-        sq_tmp = S_BLANK;
-      } else if (actual == 'w') {
-        sq_tmp = S_BLACKU;
-      } else if (actual == '*') {
-        sq_tmp = S_LIGHTBULB;
-      } else if (actual == '-') {
-        sq_tmp = S_MARK;
-      } else if (actual == '.') {
-        sq_tmp = S_BLANK;
-      } else {
-        sq_tmp = actual - '0' + S_BLACK;
-      }
-      squares[i * nb_cols + j] = sq_tmp;
+    if ((size_t)(end - p) < nb_cols) goto error;
+    for (uint j = 0; j < nb_cols; j++, p++) {
+      int s = (*p == 'b' || *p == '.') ? S_BLANK : _str2square(*p);
+      if (s < 0 || !_check_square(s)) goto error;
+      *sq++ = s;
     }
+    _skip_blanks(&p, end);
+    if (p < end && *p++ != '\n') goto error;
+  }
+
+  _flags_compute(g);
+  *pg = g;
+  return GAME_OK;
+
+error:
+  game_delete(g);
+  return GAME_ERR_FORMAT;
+}
+
+/* ************************************************************************** */
+
+/* read a whole file in a buffer */
+static game_error _read_file(const char* filename, char** pbuf, size_t* plen) {
+  FILE* f = fopen(filename, "rb");
+  if (!f) return GAME_ERR_IO;
+  size_t cap = 4096, len = 0;
+  char* buf = malloc(cap);
+  while (buf) {
+    len += fread(buf + len, 1, cap - len, f);
+    if (len < cap) break;
+    char* tmp = realloc(buf, 2 * cap);
+    if (!tmp) free(buf);
+    buf = tmp;
+    cap *= 2;
   }
+  bool failed = ferror(f);
   fclose(f);
-  game g = game_new_ext(nb_rows, nb_cols, squares,
-                        wrapping);  // new game with file indications
-  game_update_flags(g);
-  free(squares);
+  if (!buf) return GAME_ERR_MEMORY;
+  if (failed) {
+    free(buf);
+    return GAME_ERR_IO;
+  }
+  *pbuf = buf;
+  *plen = len;
+  return GAME_OK;
+}
+
+/* ************************************************************************** */
+
+game_error game_load_ext(const char* filename, game* g) {
+  if (!filename || !g) return GAME_ERR_PARAM;
+  char* buf = NULL;
+  size_t len = 0;
+  game_error err = _read_file(filename, &buf, &len);
+  if (err == GAME_OK) {
+    err = _game_parse(buf, len, g);
+    free(buf);
+  }
+  return err;
+}
+
+/* ************************************************************************** */
+
+game game_load(char* filename) {
+  game g = NULL;
+  game_error err = game_load_ext(filename, &g);
+  if (err != GAME_OK) {
+    fprintf(stderr, "ERROR: game_load(%s): %s!\n", filename ? filename : "",
+            game_strerror(err));
+    return NULL;
+  }
   return g;
 }
 
-void game_save(cgame g, char* filename) {
-  if (filename == NULL || g == NULL) {
-    fprintf(stderr, "ERROR: a parameter is empty !");
-    exit(EXIT_FAILURE);
-  }
-  uint nbrows = game_nb_rows(g);
-  uint nbcols = game_nb_cols(g);
-  FILE* fic = fopen(filename, "w");
-  fprintf(fic, "%u ", nbrows);
-  fprintf(fic, "%u ", nbcols);
-  fprintf(fic, "%u\n", game_is_wrapping(g));
-  for (uint i = 0; i < nbrows; i++) {
-    for (uint j = 0; j < nbcols; j++) {
-      if (game_is_blank(g, i, j)) {
-        fprintf(fic, "b");
-      } else {
-        char c = _square2str(SQUARE(g, i, j));
-        fprintf(fic, "%c", c);
-      }
+/* ************************************************************************** */
+
+game game_load_mem(const char* buf, size_t len) {
+  game g = NULL;
+  if (!buf || _game_parse(buf, len, &g) != GAME_OK) return NULL;
+  return g;
+}
+
+/* ************************************************************************** */
+
+size_t game_save_mem(cgame g, char* buf, size_t cap) {
+  assert(g);
+  int head = snprintf(NULL, 0, "%u %u %u\n", g->nb_rows, g->nb_cols,
+                      g->wrapping);
+  size_t len = head + (size_t)g->nb_rows * (g->nb_cols + 1);
+  if (!buf || len >= cap) return len;
+
+  snprintf(buf, cap, "%u %u %u\n", g->nb_rows, g->nb_cols, g->wrapping);
+  char* p = buf + head;
+  const square* sq = g->squares;
+  for (uint i = 0; i < g->nb_rows; i++) {
+    for (uint j = 0; j < g->nb_cols; j++, sq++) {
+      square st = *sq & S_MASK;
+      *p++ = (st == S_BLANK) ? 'b' : _square2str(st);
+    }
+    *p++ = '\n';
+  }
+  *p = '\0';
+  return len;
+}
+
+/* ************************************************************************** */
+
+/* write a buffer with a single call, and optionally flush it to disk */
+static bool _write_file(const char* filename, const char* buf, size_t len,
+                        bool sync) {
+  FILE* f = fopen(filename, "wb");
+  if (!f) return false;
+  setvbuf(f, NULL, _IONBF, 0);  // no copy into the stdio buffer
+  bool ok = (fwrite(buf, 1, len, f) == len);
+  if (ok && sync) ok = (fsync(fileno(f)) == 0);
+  ok = (fclose(f) == 0) && ok;
+  return ok;
+}
+
+/* ************************************************************************** */
+
+/* replace a file by a temporary one already on disk, then flush the directory
+ * entry so that the rename survives a power loss: this last step is best
+ * effort, the file being replaced once the rename succeeds */
+static bool _replace_file(const char* tmp, const char* filename) {
+  if (rename(tmp, filename) != 0) return false;
+  const char* slash = strrchr(filename, '/');
+  size_t len = slash ? (size_t)(slash - filename) : 1;
+  char* dir = malloc(len + 1);
+  if (!dir) return true;
+  if (!slash)
+    strcpy(dir, ".");
+  else if (len == 0)
+    strcpy(dir, "/");
+  else {
+    memcpy(dir, filename, len);
+    dir[len] = '\0';
+  }
+  int fd = open(dir, O_RDONLY);
+  free(dir);
+  if (fd >= 0) {
+    fsync(fd);
+    close(fd);
+  }
+  return true;
+}
+
+/* ************************************************************************** */
+
+game_error game_save_ext(cgame g, const char* filename, bool atomic) {
+  if (!g || !filename) return GAME_ERR_PARAM;
+  size_t len = game_save_mem(g, NULL, 0);
+  char* buf = malloc(len + 1);
+  if (!buf) return GAME_ERR_MEMORY;
+  game_save_mem(g, buf, len + 1);
+
+  game_error err = GAME_OK;
+  if (!atomic) {
+    if (!_write_file(filename, buf, len, false)) err = GAME_ERR_IO;
+  } else {
+    // write a temporary file next to the target, then replace the target
+    char* tmp = malloc(strlen(filename) + 5);
+    if (!tmp) {
+      free(buf);
+      return GAME_ERR_MEMORY;
     }
-    fprintf(fic, "\n");
+    sprintf(tmp, "%s.tmp", filename);
+    if (!_write_file(tmp, buf, len, true) || !_replace_file(tmp, filename)) {
+      remove(tmp);
+      err = GAME_ERR_IO;
+    }
+    free(tmp);
   }
-  fclose(fic);
+  free(buf);
+  return err;
+}
+
+/* ************************************************************************** */
+
+void game_save(cgame g, char* filename) {
+  game_error err = game_save_ext(g, filename, false);
+  if (err != GAME_OK)
+    fprintf(stderr, "ERROR: game_save(%s): %s!\n", filename ? filename : "",
+            game_strerror(err));
 }
 
 /* ************************************************************************** */
@@ -113,130 +290,2176 @@ bool not_exist(game g, uint* nb_sol, game* tab) {
   return true;
 }
 
+/* ************************************************************************** */
+/*                               BINARY FORMAT                                */
 /* ************************************************************************** */
 
-static bool game_is_error(game g) {
-  for (uint i = 0; i < g->nb_cols; i++) {
-    for (uint j = 0; j < g->nb_rows; j++) {
-      if (game_has_error(g, i, j)) {
-        return true;
-      }
-    }
+/* header: magic, version, flags, rows, cols, payload size, checksum */
+#define BIN_MAGIC "LUPB"
+#define BIN_VERSION 1
+#define BIN_HEADER 18
+#define BIN_WRAPPING 1 /* flag: the game is wrapping */
+#define BIN_RLE 2      /* flag: the cells are run-length encoded */
+
+/* ************************************************************************** */
+
+static void _put16(uint8_t* p, uint v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+}
+
+static void _put32(uint8_t* p, uint32_t v) {
+  for (uint k = 0; k < 4; k++) p[k] = (v >> (8 * k)) & 0xFF;
+}
+
+static uint _get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+
+static uint32_t _get32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* ************************************************************************** */
+
+/* FNV-1a checksum of the header (without the checksum) and of the payload */
+static uint32_t _checksum(const uint8_t* buf, size_t size) {
+  uint32_t h = 2166136261u;
+  for (size_t k = 0; k < BIN_HEADER - 4; k++) h = (h ^ buf[k]) * 16777619u;
+  for (size_t k = BIN_HEADER; k < size; k++) h = (h ^ buf[k]) * 16777619u;
+  return h;
+}
+
+/* ************************************************************************** */
+
+/* size of the run-length encoding: one byte per run of up to 16 squares */
+static size_t _rle_size(cgame g) {
+  uint size = g->nb_rows * g->nb_cols;
+  size_t n = 0;
+  for (uint c = 0; c < size;) {
+    square st = g->squares[c] & S_MASK;
+    uint run = 1;
+    while (run < 16 && c + run < size && (g->squares[c + run] & S_MASK) == st)
+      run++;
+    c += run;
+    n++;
   }
-  return false;
+  return n;
 }
 
-/*bool is_already_solution(game solution, uint* nbSolutions,
-                         square tab[][solution->nb_rows * solution->nb_cols]) {
-  bool is_same;
-  for (uint i = 0; i < *nbSolutions; i++) {
-    is_same = true;
-    for (uint j = 0; j < solution->nb_rows * solution->nb_cols; j++) {
-      if (solution->squares[j] != tab[i][j]) {
-        is_same = false;
-      }
-    }
-    if (is_same) {
-      return true;
+/* ************************************************************************** */
+
+size_t game_encode(cgame g, uint8_t* buf, size_t cap) {
+  assert(g);
+  assert(g->nb_rows <= 0xFFFF && g->nb_cols <= 0xFFFF);
+  uint size = g->nb_rows * g->nb_cols;
+  size_t nibbles = (size + 1) / 2, runs = _rle_size(g);
+  bool rle = (runs < nibbles);
+  size_t payload = rle ? runs : nibbles;
+  size_t len = BIN_HEADER + payload;
+  if (!buf || len > cap) return len;
+
+  memcpy(buf, BIN_MAGIC, 4);
+  buf[4] = BIN_VERSION;
+  buf[5] = (g->wrapping ? BIN_WRAPPING : 0) | (rle ? BIN_RLE : 0);
+  _put16(buf + 6, g->nb_rows);
+  _put16(buf + 8, g->nb_cols);
+  _put32(buf + 10, payload);
+  uint8_t* p = buf + BIN_HEADER;
+  if (rle) {
+    for (uint c = 0; c < size;) {
+      square st = g->squares[c] & S_MASK;
+      uint run = 1;
+      while (run < 16 && c + run < size &&
+             (g->squares[c + run] & S_MASK) == st)
+        run++;
+      *p++ = (st << 4) | (run - 1);
+      c += run;
     }
+  } else {
+    memset(p, 0, payload);
+    for (uint c = 0; c < size; c++)
+      p[c / 2] |= (g->squares[c] & S_MASK) << (4 * (c % 2));
   }
-  return false;
+  _put32(buf + 14, _checksum(buf, len));
+  return len;
 }
 
-void print_all_solutions(uint pos, game solution,
-                         square tab[][solution->nb_rows * solution->nb_cols],
-                         uint* nbSolutions) {
-  if (pos == (solution->nb_rows * solution->nb_cols)) {
-    game_update_flags(solution);
-    if (game_is_over(solution)) {
-      if (*nbSolutions == 0 ||
-          !is_already_solution(solution, nbSolutions, tab)) {
-        (*nbSolutions)++;
-        for (uint i = 0; i < solution->nb_rows * solution->nb_cols; i++) {
-          tab[*nbSolutions][i] = solution->squares[i];
-        }
-      }
+/* ************************************************************************** */
+
+/* check the fields of the BIN_HEADER bytes of an encoded game, the payload
+ * length being consistent with the size of the game */
+static bool _check_header(const uint8_t* buf) {
+  if (memcmp(buf, BIN_MAGIC, 4) != 0 || buf[4] != BIN_VERSION) return false;
+  if (buf[5] & ~(BIN_WRAPPING | BIN_RLE)) return false;
+  size_t size = (size_t)_get16(buf + 6) * _get16(buf + 8);
+  size_t payload = _get32(buf + 10);
+  if (size == 0) return false;
+  if (buf[5] & BIN_RLE)  // runs of 1 to 16 squares
+    return payload <= size && size <= 16 * payload;
+  return payload == (size + 1) / 2;
+}
+
+/* ************************************************************************** */
+
+/* check the header of an encoded game, and get its size and options */
+static bool _decode_header(const uint8_t* buf, size_t len, uint* nb_rows,
+                           uint* nb_cols, bool* wrapping) {
+  if (!buf || len < BIN_HEADER || !_check_header(buf)) return false;
+  size_t payload = _get32(buf + 10);
+  if (payload > len - BIN_HEADER) return false;
+  if (_get32(buf + 14) != _checksum(buf, BIN_HEADER + payload)) return false;
+  *nb_rows = _get16(buf + 6);
+  *nb_cols = _get16(buf + 8);
+  *wrapping = buf[5] & BIN_WRAPPING;
+  return true;
+}
+
+/* ************************************************************************** */
+
+/* decode the size squares of a game with a valid header into squares, or
+ * only check them if squares is NULL */
+static bool _decode_squares(const uint8_t* buf, uint size, square* squares) {
+  const uint8_t* p = buf + BIN_HEADER;
+  size_t payload = _get32(buf + 10);
+  uint c = 0;
+  if (buf[5] & BIN_RLE) {
+    for (size_t k = 0; k < payload; k++) {
+      uint run = (p[k] & 0xF) + 1;
+      if (c + run > size || !_check_square(p[k] >> 4)) return false;
+      for (uint l = 0; squares && l < run; l++) squares[c + l] = p[k] >> 4;
+      c += run;
     }
-    return;
+    return c == size;
   }
-  if (!game_is_black(solution, pos / solution->nb_rows,
-                     pos % solution->nb_cols)) {
-    solution->squares[pos] = S_BLANK;
+  for (; c < size; c++) {
+    square s = (p[c / 2] >> (4 * (c % 2))) & 0xF;
+    if (!_check_square(s)) return false;
+    if (squares) squares[c] = s;
   }
-  print_all_solutions(pos + 1, solution, tab, nbSolutions);
-  if (!game_is_black(solution, pos / solution->nb_rows,
-                     pos % solution->nb_cols)) {
-    solution->squares[pos] = S_LIGHTBULB;
+  return true;
+}
+
+/* ************************************************************************** */
+
+game game_decode(const uint8_t* buf, size_t len) {
+  uint nb_rows, nb_cols;
+  bool wrapping;
+  if (!_decode_header(buf, len, &nb_rows, &nb_cols, &wrapping)) return NULL;
+  if (!_decode_squares(buf, nb_rows * nb_cols, NULL)) return NULL;
+  game g = game_new_empty_ext(nb_rows, nb_cols, wrapping);
+  _decode_squares(buf, nb_rows * nb_cols, g->squares);
+  _flags_compute(g);
+  return g;
+}
+
+/* ************************************************************************** */
+/*                                PUZZLE IDS                                  */
+/* ************************************************************************** */
+
+game game_load_id(const char* id, size_t len) {
+  if (!id) return NULL;
+  const char *p = id, *end = id + len;
+  uint nb_cols, nb_rows;
+  if (!_parse_uint(&p, end, &nb_cols) || p == end || *p++ != 'x' ||
+      !_parse_uint(&p, end, &nb_rows))
+    return NULL;
+  bool wrapping = (p < end && *p == 'w');
+  if (wrapping) p++;
+  if (p == end || *p++ != ':' || nb_rows == 0 || nb_cols == 0) return NULL;
+  // each character gives at least one square
+  if ((size_t)nb_rows * nb_cols > 26 * (size_t)(end - p)) return NULL;
+
+  game g = game_new_empty_ext(nb_rows, nb_cols, wrapping);
+  uint size = nb_rows * nb_cols, c = 0;
+  for (; p < end && *p != '\n' && *p != '\r' && *p != ' '; p++) {
+    if (*p >= 'a' && *p <= 'z') {
+      uint run = *p - 'a' + 1;  // blanks are already there
+      if (c + run > size) goto error;
+      c += run;
+    } else if (c < size && *p >= '0' && *p <= '4') {
+      g->squares[c++] = S_BLACK + (*p - '0');
+    } else if (c < size && *p == 'B') {
+      g->squares[c++] = S_BLACKU;
+    } else
+      goto error;
   }
-  print_all_solutions(pos + 1, solution, tab, nbSolutions);
+  if (c != size) goto error;
+  _flags_compute(g);
+  return g;
+
+error:
+  game_delete(g);
+  return NULL;
 }
-*/
-static void game_solveur(uint position, game g, bool* solved) {
-  if (position == (g->nb_rows * g->nb_cols)) {
-    if (game_is_over(g)) {
-      *solved = true;
-      return;
-    } else {
-      return;
+
+/* ************************************************************************** */
+
+size_t game_save_id(cgame g, char* buf, size_t cap) {
+  assert(g);
+  int head = snprintf(NULL, 0, "%ux%u%s:", g->nb_cols, g->nb_rows,
+                      g->wrapping ? "w" : "");
+  uint size = g->nb_rows * g->nb_cols;
+
+  // one character per wall, and per run of up to 26 other squares
+  size_t len = head;
+  for (uint c = 0, run = 0; c <= size; c++) {
+    bool black = (c < size) && (g->squares[c] & S_BLACK);
+    if (c < size && !black) run++;
+    if ((black || c == size || run == 26) && run > 0) {
+      len++;
+      run = 0;
     }
+    if (black) len++;
   }
-  if (!game_is_black(g, position / g->nb_cols, position % g->nb_cols) &&
-      !game_is_lighted(g, position / g->nb_cols, position % g->nb_cols)) {
-    g->squares[position] = S_LIGHTBULB;
-    game_update_flags(g);
-    if (game_is_error(g)) {
-      g->squares[position] = S_BLANK;
-      game_update_flags(g);
+  if (!buf || len >= cap) return len;
+
+  snprintf(buf, cap, "%ux%u%s:", g->nb_cols, g->nb_rows,
+           g->wrapping ? "w" : "");
+  char* p = buf + head;
+  for (uint c = 0, run = 0; c <= size; c++) {
+    square st = (c < size) ? g->squares[c] & S_MASK : S_BLANK;
+    bool black = (c < size) && (st & S_BLACK);
+    if (c < size && !black) run++;
+    if ((black || c == size || run == 26) && run > 0) {
+      *p++ = 'a' + run - 1;
+      run = 0;
     }
-    game_solveur(position + 1, g, solved);
+    if (black) *p++ = (st == S_BLACKU) ? 'B' : '0' + (st - S_BLACK);
   }
+  *p = '\0';
+  return len;
+}
 
-  if (*solved == true) {
-    return;
+/* ************************************************************************** */
+/*                                   PACKS                                    */
+/* ************************************************************************** */
+
+/* header: magic, version, 3 zero bytes, number of games, then the offsets of
+ * the games and of the end of the file */
+#define PACK_MAGIC "LUPK"
+#define PACK_VERSION 1
+#define PACK_HEADER 12
+
+/** pack of games mapped in memory */
+struct game_pack_s {
+  const uint8_t* data; /**< content of the file */
+  size_t size;         /**< size of the file */
+  uint nb_games;       /**< number of games */
+};
+
+/* ************************************************************************** */
+
+static void _put64(uint8_t* p, uint64_t v) {
+  for (uint k = 0; k < 8; k++) p[k] = (v >> (8 * k)) & 0xFF;
+}
+
+static uint64_t _get64(const uint8_t* p) {
+  return _get32(p) | ((uint64_t)_get32(p + 4) << 32);
+}
+
+/* ************************************************************************** */
+
+game_error game_pack_write(const char* filename, const cgame* games, uint n) {
+  if (!filename || (n > 0 && !games)) return GAME_ERR_PARAM;
+  size_t len = PACK_HEADER + 8 * ((size_t)n + 1);
+  for (uint k = 0; k < n; k++) len += game_encode(games[k], NULL, 0);
+  uint8_t* buf = malloc(len);
+  if (!buf) return GAME_ERR_MEMORY;
+
+  memcpy(buf, PACK_MAGIC, 4);
+  buf[4] = PACK_VERSION;
+  buf[5] = buf[6] = buf[7] = 0;
+  _put32(buf + 8, n);
+  uint8_t* index = buf + PACK_HEADER;
+  size_t pos = PACK_HEADER + 8 * ((size_t)n + 1);
+  for (uint k = 0; k < n; k++) {
+    _put64(index + 8 * k, pos);
+    pos += game_encode(games[k], buf + pos, len - pos);
   }
-  if (!game_is_black(g, position / g->nb_cols, position % g->nb_cols)) {
-    g->squares[position] = S_BLANK;
-    game_update_flags(g);
+  _put64(index + 8 * (size_t)n, pos);
+
+  game_error err = _write_file(filename, (char*)buf, len, false) ? GAME_OK
+                                                                 : GAME_ERR_IO;
+  free(buf);
+  return err;
+}
+
+/* ************************************************************************** */
+
+/* map a whole file of at least min_size bytes in memory, read-only */
+static const uint8_t* _map_file(const char* filename, size_t min_size,
+                                size_t* psize) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) return NULL;
+  struct stat st;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= min_size)
+    data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  // the mapping stays valid
+  if (data == MAP_FAILED) return NULL;
+  *psize = st.st_size;
+  return data;
+}
+
+/* ************************************************************************** */
+
+game_pack game_pack_open(const char* filename) {
+  if (!filename) return NULL;
+  size_t size;
+  const uint8_t* p = _map_file(filename, PACK_HEADER, &size);
+  if (!p) return NULL;
+
+  // only the header is checked here, the index is checked on access
+  uint n = _get32(p + 8);
+  uint64_t index_end = PACK_HEADER + 8 * ((uint64_t)n + 1);
+  game_pack pack = malloc(sizeof(struct game_pack_s));
+  if (!pack || memcmp(p, PACK_MAGIC, 4) != 0 || p[4] != PACK_VERSION ||
+      index_end > size) {
+    free(pack);
+    munmap((void*)p, size);
+    return NULL;
   }
-  game_solveur(position + 1, g, solved);
+  pack->data = p;
+  pack->size = size;
+  pack->nb_games = n;
+  return pack;
 }
 
-bool game_solve(game g) {
-  bool solved = false;
-  game_solveur(0, g, &solved);
-  return solved;
+/* ************************************************************************** */
+
+uint game_pack_size(game_pack pack) {
+  assert(pack);
+  return pack->nb_games;
 }
 
-static void game_nb_sol_aux(uint position, game g, uint* cpt) {
-  if (position == (g->nb_rows * g->nb_cols)) {
-    if (game_is_over(g)) {
-      (*cpt)++;
-      return;
-    } else {
-      return;
+/* ************************************************************************** */
+
+game game_pack_get(game_pack pack, uint k) {
+  assert(pack && k < pack->nb_games);
+  const uint8_t* index = pack->data + PACK_HEADER;
+  uint64_t start = _get64(index + 8 * (size_t)k);
+  uint64_t end = _get64(index + 8 * ((size_t)k + 1));
+  if (start > end || end > pack->size) return NULL;
+  return game_decode(pack->data + start, end - start);
+}
+
+/* ************************************************************************** */
+
+bool game_pack_get_into(game_pack pack, uint k, game g) {
+  assert(pack && k < pack->nb_games && g);
+  const uint8_t* index = pack->data + PACK_HEADER;
+  uint64_t start = _get64(index + 8 * (size_t)k);
+  uint64_t end = _get64(index + 8 * ((size_t)k + 1));
+  if (start > end || end > pack->size) return false;
+  const uint8_t* buf = pack->data + start;
+  uint nb_rows, nb_cols;
+  bool wrapping;
+  if (!_decode_header(buf, end - start, &nb_rows, &nb_cols, &wrapping))
+    return false;
+  if (nb_rows != g->nb_rows || nb_cols != g->nb_cols || wrapping != g->wrapping)
+    return false;
+  if (!_decode_squares(buf, nb_rows * nb_cols, NULL)) return false;
+
+  _own_squares(g);
+  _decode_squares(buf, nb_rows * nb_cols, g->squares);
+  _flags_compute(g);
+  _history_clear(g);
+  if (g->journal) _journal_append(g);
+  return true;
+}
+
+/* ************************************************************************** */
+
+void game_pack_close(game_pack pack) {
+  if (!pack) return;
+  munmap((void*)pack->data, pack->size);
+  free(pack);
+}
+
+/* ************************************************************************** */
+/*                                  READER                                    */
+/* ************************************************************************** */
+
+#define READER_CHUNK 65536
+#define READER_HEADER_MAX 64 /* longest header line, or start of a puzzle ID */
+#define READER_MARGIN 8      /* bytes of a line beyond its squares (blanks) */
+
+/** reader of games stored one after the other in a stream */
+struct game_reader_s {
+  FILE* f;         /**< input stream */
+  bool owned;      /**< the stream is closed with the reader */
+  char* buf;       /**< buffer, reused for all games */
+  size_t cap;      /**< size of the buffer */
+  size_t start;    /**< first unread byte in the buffer */
+  size_t end;      /**< end of the data in the buffer */
+  bool eof;        /**< the end of the stream is in the buffer */
+  game_error err;  /**< first error met */
+};
+
+/* ************************************************************************** */
+
+game_reader game_reader_new(FILE* f) {
+  if (!f) return NULL;
+  game_reader r = malloc(sizeof(struct game_reader_s));
+  char* buf = malloc(READER_CHUNK);
+  if (!r || !buf) {
+    free(r);
+    free(buf);
+    return NULL;
+  }
+  *r = (struct game_reader_s){f, false, buf, READER_CHUNK, 0, 0, false,
+                              GAME_OK};
+  return r;
+}
+
+/* ************************************************************************** */
+
+game_reader game_reader_open(const char* filename) {
+  if (!filename) return NULL;
+  FILE* f = fopen(filename, "rb");
+  if (!f) return NULL;
+  game_reader r = game_reader_new(f);
+  if (!r) {
+    fclose(f);
+    return NULL;
+  }
+  r->owned = true;
+  return r;
+}
+
+/* ************************************************************************** */
+
+/* make at least n unread bytes available, return false if the stream ends
+ * before */
+static bool _fill(game_reader r, size_t n) {
+  while (r->end - r->start < n && !r->eof) {
+    if (r->start > 0) {  // move unread data to the front
+      memmove(r->buf, r->buf + r->start, r->end - r->start);
+      r->end -= r->start;
+      r->start = 0;
+    }
+    if (r->cap - r->end < READER_CHUNK / 2) {  // only for a large game
+      // doubled as the data comes, so that a corrupted length asks for no
+      // more memory than the stream holds
+      size_t cap = 2 * r->cap;
+      char* buf = realloc(r->buf, cap);
+      if (!buf) {
+        r->err = GAME_ERR_MEMORY;
+        return false;
+      }
+      r->buf = buf;
+      r->cap = cap;
+    }
+    size_t nb = fread(r->buf + r->end, 1, r->cap - r->end, r->f);
+    r->end += nb;
+    if (nb == 0) {
+      r->eof = true;
+      if (ferror(r->f)) r->err = GAME_ERR_IO;
+    }
+  }
+  return r->end - r->start >= n;
+}
+
+/* ************************************************************************** */
+
+/* end of the next n lines after the first len bytes (the last one may end
+ * the stream), each of at most max bytes with its end of line: the error is
+ * set if a line is longer, so that the buffer stays bounded */
+static size_t _lines(game_reader r, size_t len, uint n, size_t max) {
+  for (uint k = 0; k < n; k++) {
+    for (size_t l = 0;; l++) {
+      if (l == max) {
+        r->err = GAME_ERR_FORMAT;
+        return len;
+      }
+      if (!_fill(r, len + 1)) return len;
+      if (r->buf[r->start + len++] == '\n') break;
     }
   }
-  if (!game_is_black(g, position / g->nb_cols, position % g->nb_cols) &&
-      !game_is_lighted(g, position / g->nb_cols, position % g->nb_cols)) {
-    g->squares[position] = S_LIGHTBULB;
-    game_update_flags(g);
-    if (!game_is_error(g)) {
-      /*g->squares[position] = S_BLANK;
-      game_update_flags(g);*/
-      game_nb_sol_aux(position + 1, g, cpt);
+  return len;
+}
+
+/* ************************************************************************** */
+
+/* blank character between games (a NUL byte is not) */
+static bool _is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/* ************************************************************************** */
+
+game game_reader_next(game_reader r) {
+  assert(r);
+  if (r->err != GAME_OK) return NULL;
+  // skip empty lines between games
+  while (_fill(r, 1) && _is_space(r->buf[r->start])) r->start++;
+  if (r->end == r->start) return NULL;  // end of stream
+
+  game g = NULL;
+  if (_fill(r, 4) && memcmp(r->buf + r->start, BIN_MAGIC, 4) == 0) {
+    // binary format: the header gives the size
+    size_t len = BIN_HEADER;
+    if (_fill(r, BIN_HEADER) && _check_header((uint8_t*)r->buf + r->start)) {
+      len += _get32((uint8_t*)r->buf + r->start + 10);
+      if (_fill(r, len)) g = game_decode((uint8_t*)r->buf + r->start, len);
+    }
+    r->start += (r->end - r->start < len) ? r->end - r->start : len;
+  } else {
+    // text format or puzzle ID, depending on the start of the first line,
+    // which also bounds the length of the lines
+    _fill(r, READER_HEADER_MAX);
+    size_t len = r->end - r->start;
+    if (len > READER_HEADER_MAX) len = READER_HEADER_MAX;
+    const char *p = r->buf + r->start, *q = p, *end = p + len;
+    uint a = 0, b = 0;
+    bool id = _parse_uint(&q, end, &a) && q < end && *q == 'x';
+    if (id) {
+      // each character of a puzzle ID gives at least one square
+      q++;
+      size_t max = READER_HEADER_MAX;
+      if (_parse_uint(&q, end, &b)) max += (size_t)a * b;
+      len = _lines(r, 0, 1, max);
+      if (r->err == GAME_OK) g = game_load_id(r->buf + r->start, len);
+    } else {
+      // header "nb_rows nb_cols wrapping", then one line per row
+      size_t hdr = _lines(r, 0, 1, READER_HEADER_MAX);
+      q = r->buf + r->start;
+      end = q + hdr;
+      if (_parse_uint(&q, end, &a) && _parse_uint(&q, end, &b))
+        len = _lines(r, hdr, a, (size_t)b + READER_MARGIN);
+      else
+        len = hdr;
+      if (r->err == GAME_OK) _game_parse(r->buf + r->start, len, &g);
     }
-    // game_nb_sol_aux(position + 1, g, cpt, tab);
+    r->start += len;
   }
 
-  if (!game_is_black(g, position / g->nb_cols, position % g->nb_cols)) {
-    g->squares[position] = S_BLANK;
-    game_update_flags(g);
+  if (!g && r->err == GAME_OK) r->err = GAME_ERR_FORMAT;
+  return g;
+}
+
+/* ************************************************************************** */
+
+game_error game_reader_error(game_reader r) {
+  assert(r);
+  return r->err;
+}
+
+/* ************************************************************************** */
+
+void game_reader_delete(game_reader r) {
+  if (!r) return;
+  if (r->owned) fclose(r->f);
+  free(r->buf);
+  free(r);
+}
+
+/* ************************************************************************** */
+/*                                 SESSIONS                                   */
+/* ************************************************************************** */
+
+/* header: magic, version, 3 zero bytes, then records appended one after the
+ * other, each batch of records ending with a cursor record */
+#define SESSION_MAGIC "LUPS"
+#define SESSION_VERSION 1
+#define SESSION_HEADER 8
+
+/* records, after a one-byte tag */
+#define REC_BASE 'B'   /* u32 size, encoded board: new board, no history */
+#define REC_MOVE 'M'   /* u16 i, u16 j, u8 old, u8 new: move played */
+#define REC_TRUNC 'T'  /* u32 k: history cut to its first k moves */
+#define REC_CURSOR 'C' /* u32 k: k moves played, the others undone */
+#define REC_MOVE_SIZE 7
+#define REC_U32_SIZE 5
+#define REC_LINKED 0x80 /* bit of new: undone with the previous move */
+
+/** session file attached to a game */
+struct game_session_s {
+  game g;          /**< the game */
+  FILE* f;         /**< session file, opened for appending */
+  char* filename;  /**< name of the session file */
+  uint nb;         /**< number of moves in the file */
+  uint cur;        /**< cursor in the file */
+  uint pending;    /**< syncs not forced to disk yet (journal only) */
+  time_t forced;   /**< time of the last fsync (journal only) */
+  game_error err;  /**< first error met (journal only) */
+};
+
+/* ************************************************************************** */
+
+/* copy of the board before the first move of the history (without flags) */
+static game _history_base(cgame g) {
+  game base = game_copy(g);
+  for (uint k = g->cursor; k > 0; k--) {
+    move m = g->history[k - 1];
+    SQUARE(base, m.i, m.j) = m.old;
   }
-  game_nb_sol_aux(position + 1, g, cpt);
+  return base;
 }
 
-uint game_nb_solutions(game g) {
-  uint nb_solve = 0;
-  game_nb_sol_aux(0, g, &nb_solve);
-  return nb_solve;
+/* ************************************************************************** */
+
+/* append a record with a 32-bit value */
+static uint8_t* _put_rec32(uint8_t* p, uint8_t tag, uint32_t v) {
+  p[0] = tag;
+  _put32(p + 1, v);
+  return p + REC_U32_SIZE;
+}
+
+/* ************************************************************************** */
+
+/* records of the moves of the history from first on, then of the cursor */
+static uint8_t* _put_moves(uint8_t* p, cgame g, uint first) {
+  for (uint k = first; k < g->nb_moves; k++) {
+    move m = g->history[k];
+    p[0] = REC_MOVE;
+    _put16(p + 1, m.i);
+    _put16(p + 3, m.j);
+    p[5] = m.old;
+    p[6] = m.new | (m.linked ? REC_LINKED : 0);
+    p += REC_MOVE_SIZE;
+  }
+  return _put_rec32(p, REC_CURSOR, g->cursor);
 }
+
+/* ************************************************************************** */
+
+/* write the whole history to "<filename>.tmp", force it to disk and rename it
+ * over the session file, so that a crash leaves the old file or the new one,
+ * never a truncated one */
+static game_error _session_rewrite(game_session s) {
+  game g = s->g;
+  game base = _history_base(g);
+  size_t base_len = game_encode(base, NULL, 0);
+  size_t len = SESSION_HEADER + REC_U32_SIZE + base_len + REC_U32_SIZE +
+               REC_MOVE_SIZE * (size_t)g->nb_moves;
+  uint8_t* buf = malloc(len);
+  char* tmp = malloc(strlen(s->filename) + 5);
+  if (!buf || !tmp) {
+    game_delete(base);
+    free(buf);
+    free(tmp);
+    return GAME_ERR_MEMORY;
+  }
+  memset(buf, 0, SESSION_HEADER);
+  memcpy(buf, SESSION_MAGIC, 4);
+  buf[4] = SESSION_VERSION;
+  uint8_t* p = _put_rec32(buf + SESSION_HEADER, REC_BASE, base_len);
+  p += game_encode(base, p, base_len);
+  game_delete(base);
+  _put_moves(p, g, 0);
+
+  sprintf(tmp, "%s.tmp", s->filename);
+  bool ok = _write_file(tmp, (char*)buf, len, true) &&
+            _replace_file(tmp, s->filename);
+  if (!ok) remove(tmp);
+  free(buf);
+  free(tmp);
+  FILE* f = ok ? fopen(s->filename, "ab") : NULL;
+  if (!f) return GAME_ERR_IO;
+  if (s->f) fclose(s->f);
+  s->f = f;
+  s->nb = g->nb_moves;
+  s->cur = g->cursor;
+  g->synced = g->nb_moves;
+  g->cleared = false;
+  return GAME_OK;
+}
+
+/* ************************************************************************** */
+
+game_session game_session_create(game g, const char* filename) {
+  if (!g || !filename) return NULL;
+  game_session s = malloc(sizeof(struct game_session_s));
+  char* name = malloc(strlen(filename) + 1);
+  if (!s || !name) {
+    free(s);
+    free(name);
+    return NULL;
+  }
+  strcpy(name, filename);
+  *s = (struct game_session_s){g, NULL, name, 0, 0, 0, 0, GAME_OK};
+  g->cleared = true;  // the first sync writes the whole history
+  if (game_session_sync(s) != GAME_OK) {
+    game_session_close(s);
+    return NULL;
+  }
+  return s;
+}
+
+/* ************************************************************************** */
+
+game_error game_session_sync(game_session s) {
+  assert(s);
+  game g = s->g;
+  if (g->cleared) return _session_rewrite(s);  // a new board
+  uint first = g->synced;  // first move to write
+  if (first == s->nb && g->nb_moves == s->nb && g->cursor == s->cur)
+    return GAME_OK;  // nothing new
+
+  size_t len = 2 * REC_U32_SIZE + REC_MOVE_SIZE * (size_t)(g->nb_moves - first);
+  uint8_t* buf = malloc(len);
+  if (!buf) return GAME_ERR_MEMORY;
+  uint8_t* p = buf;
+  if (first < s->nb) p = _put_rec32(p, REC_TRUNC, first);
+  p = _put_moves(p, g, first);
+
+  // a single write per sync: a crash loses at most the last batch
+  size_t n = p - buf;
+  bool ok = (fwrite(buf, 1, n, s->f) == n && fflush(s->f) == 0);
+  free(buf);
+  if (!ok) return GAME_ERR_IO;
+  s->nb = g->nb_moves;
+  s->cur = g->cursor;
+  g->synced = g->nb_moves;
+  return GAME_OK;
+}
+
+/* ************************************************************************** */
+
+void game_session_close(game_session s) {
+  if (!s) return;
+  if (s->f) fclose(s->f);
+  free(s->filename);
+  free(s);
+}
+
+/* ************************************************************************** */
+
+/* size of the record at p, 0 if it is truncated or unknown */
+static size_t _rec_size(const uint8_t* p, const uint8_t* end) {
+  if (end - p < REC_U32_SIZE) return 0;
+  size_t size = 0;
+  if (p[0] == REC_BASE)
+    size = REC_U32_SIZE + (size_t)_get32(p + 1);
+  else if (p[0] == REC_MOVE)
+    size = REC_MOVE_SIZE;
+  else if (p[0] == REC_TRUNC || p[0] == REC_CURSOR)
+    size = REC_U32_SIZE;
+  return (size <= (size_t)(end - p)) ? size : 0;
+}
+
+/* ************************************************************************** */
+
+/* replay the records in [p,end), which ends with a cursor record */
+static game _replay(const uint8_t* p, const uint8_t* end) {
+  game g = NULL;
+  move* history = NULL;
+  uint nb = 0, cur = 0, cap = 0;
+  bool ok = true;
+  while (ok && p < end) {
+    size_t size = _rec_size(p, end);
+    if (p[0] == REC_BASE) {
+      if (g) game_delete(g);
+      g = game_decode(p + REC_U32_SIZE, size - REC_U32_SIZE);
+      ok = (g != NULL);
+      nb = cur = 0;
+    } else if (p[0] == REC_MOVE) {
+      move m = {_get16(p + 1), _get16(p + 3), p[5], p[6] & ~REC_LINKED,
+                p[6] & REC_LINKED};
+      ok = g && m.i < g->nb_rows && m.j < g->nb_cols &&
+           !(SQUARE(g, m.i, m.j) & S_BLACK) && m.old <= S_MARK &&
+           m.new <= S_MARK;
+      if (ok && nb == cap) {
+        cap = cap ? 2 * cap : 16;
+        move* tmp = realloc(history, cap * sizeof(move));
+        if (tmp) history = tmp;
+        ok = (tmp != NULL);
+      }
+      if (ok) history[nb++] = m;
+      cur = nb;
+    } else {  // truncate or cursor
+      uint k = _get32(p + 1);
+      ok = (k <= nb);
+      if (ok && p[0] == REC_TRUNC) nb = k;
+      cur = k;
+    }
+    p += size;
+  }
+  if (!ok) {
+    if (g) game_delete(g);
+    free(history);
+    return NULL;
+  }
+
+  // play the moves on the base board, then update flags once
+  for (uint k = 0; k < cur; k++)
+    SQUARE(g, history[k].i, history[k].j) = history[k].new;
+  _flags_compute(g);
+  free(g->history);
+  g->history = history;
+  g->nb_moves = nb;
+  g->cursor = cur;
+  g->capacity = cap;
+  return g;
+}
+
+/* ************************************************************************** */
+
+game game_session_restore(const char* filename) {
+  if (!filename) return NULL;
+  char* buf = NULL;
+  size_t len = 0;
+  if (_read_file(filename, &buf, &len) != GAME_OK) return NULL;
+  const uint8_t* data = (uint8_t*)buf;
+  game g = NULL;
+  if (len >= SESSION_HEADER && memcmp(data, SESSION_MAGIC, 4) == 0 &&
+      data[4] == SESSION_VERSION) {
+    // find the end of the last complete batch, ignoring a truncated tail
+    const uint8_t *p = data + SESSION_HEADER, *end = data + len;
+    const uint8_t* last = NULL;
+    size_t size;
+    while (p < end && (size = _rec_size(p, end)) > 0) {
+      if (p[0] == REC_CURSOR) last = p + size;
+      p += size;
+    }
+    if (last && data[SESSION_HEADER] == REC_BASE)
+      g = _replay(data + SESSION_HEADER, last);
+  }
+  free(buf);
+  return g;
+}
+
+/* ************************************************************************** */
+/*                                  JOURNAL                                   */
+/* ************************************************************************** */
+
+/* group commit: syncs are forced to disk by batches, or once per second */
+#define JOURNAL_BATCH 64
+
+/* ************************************************************************** */
+
+static bool _force(game_session s) {
+  s->pending = 0;
+  s->forced = time(NULL);
+  return fsync(fileno(s->f)) == 0;
+}
+
+/* ************************************************************************** */
+
+game_error game_journal_attach(game g, const char* filename) {
+  if (!g || !filename) return GAME_ERR_PARAM;
+  if (g->journal) _journal_close(g);
+  game_session s = game_session_create(g, filename);
+  if (!s) return GAME_ERR_IO;
+  if (!_force(s)) {
+    game_session_close(s);
+    return GAME_ERR_IO;
+  }
+  g->journal = s;
+  return GAME_OK;
+}
+
+/* ************************************************************************** */
+
+void _journal_append(game g) {
+  game_session s = g->journal;
+  if (s->err != GAME_OK) return;  // stop at the first error
+  s->err = game_session_sync(s);
+  if (s->err == GAME_OK &&
+      (++s->pending >= JOURNAL_BATCH || time(NULL) != s->forced) &&
+      !_force(s))
+    s->err = GAME_ERR_IO;
+}
+
+/* ************************************************************************** */
+
+bool _journal_close(game g) {
+  game_session s = g->journal;
+  if (s->err == GAME_OK) s->err = game_session_sync(s);
+  if (s->err == GAME_OK && !_force(s)) s->err = GAME_ERR_IO;
+  bool ok = (s->err == GAME_OK);
+  game_session_close(s);
+  g->journal = NULL;
+  return ok;
+}
+
+/* ************************************************************************** */
+
+game_error game_journal_detach(game g) {
+  if (!g) return GAME_ERR_PARAM;
+  if (!g->journal) return GAME_OK;
+  game_error err = g->journal->err;
+  bool ok = _journal_close(g);
+  return ok ? GAME_OK : (err != GAME_OK ? err : GAME_ERR_IO);
+}
+
+/* ************************************************************************** */
+/*                                  REPLAYS                                   */
+/* ************************************************************************** */
+
+/* header: magic, version, 3 zero bytes, keyframe interval, number of moves,
+ * then the offsets of the keyframes and of the end of the file, the moves,
+ * and the keyframes (boards before moves 0, K, 2K...) */
+#define REPLAY_MAGIC "LUPR"
+#define REPLAY_VERSION 1
+#define REPLAY_HEADER 16
+#define REPLAY_MOVE_SIZE 6 /* u16 i, u16 j, u8 old, u8 new */
+
+/** replay file mapped in memory, with the board at the current move */
+struct game_replay_s {
+  const uint8_t* data;  /**< content of the file */
+  size_t size;          /**< size of the file */
+  uint interval;        /**< number of moves between two keyframes */
+  uint nb_moves;        /**< number of moves */
+  const uint8_t* moves; /**< moves in the file */
+  game g;               /**< board after the first pos moves */
+  uint pos;             /**< current move */
+};
+
+/* ************************************************************************** */
+
+/* play the moves of g again on its base board, with a keyframe every interval
+ * moves from pos on, and return the end of the last one: the keyframes and
+ * their index are written in buf of size len, or only measured if buf is NULL
+ * (each board is packed its own way, so their sizes differ) */
+static size_t _put_keyframes(cgame g, uint interval, uint8_t* buf, size_t pos,
+                             size_t len) {
+  uint n = g->cursor, nb_keys = n / interval + 1;
+  game b = _history_base(g);
+  for (uint k = 0; k <= n; k++) {
+    if (k % interval == 0) {
+      if (buf) _put64(buf + REPLAY_HEADER + 8 * (size_t)(k / interval), pos);
+      pos += game_encode(b, buf ? buf + pos : NULL, buf ? len - pos : 0);
+    }
+    if (k < n) SQUARE(b, g->history[k].i, g->history[k].j) = g->history[k].new;
+  }
+  if (buf) _put64(buf + REPLAY_HEADER + 8 * (size_t)nb_keys, pos);
+  game_delete(b);
+  return pos;
+}
+
+/* ************************************************************************** */
+
+game_error game_replay_write(const char* filename, cgame g, uint interval) {
+  if (!filename || !g || interval == 0) return GAME_ERR_PARAM;
+  uint n = g->cursor, nb_keys = n / interval + 1;
+  size_t index = REPLAY_HEADER + 8 * ((size_t)nb_keys + 1);
+  size_t moves = index + REPLAY_MOVE_SIZE * (size_t)n;
+  size_t len = _put_keyframes(g, interval, NULL, moves, 0);
+  uint8_t* buf = malloc(len);
+  if (!buf) return GAME_ERR_MEMORY;
+
+  memcpy(buf, REPLAY_MAGIC, 4);
+  buf[4] = REPLAY_VERSION;
+  buf[5] = buf[6] = buf[7] = 0;
+  _put32(buf + 8, interval);
+  _put32(buf + 12, n);
+  uint8_t* p = buf + index;
+  for (uint k = 0; k < n; k++, p += REPLAY_MOVE_SIZE) {
+    move m = g->history[k];
+    _put16(p, m.i);
+    _put16(p + 2, m.j);
+    p[4] = m.old;
+    p[5] = m.new;
+  }
+  size_t end = _put_keyframes(g, interval, buf, moves, len);
+  assert(end == len);
+  (void)end;
+
+  game_error err = _write_file(filename, (char*)buf, len, false) ? GAME_OK
+                                                                 : GAME_ERR_IO;
+  free(buf);
+  return err;
+}
+
+/* ************************************************************************** */
+
+/* decode the keyframe before move k*interval */
+static game _keyframe(game_replay r, uint k) {
+  const uint8_t* index = r->data + REPLAY_HEADER + 8 * (size_t)k;
+  uint64_t start = _get64(index), end = _get64(index + 8);
+  if (start > end || end > r->size) return NULL;
+  game g = game_decode(r->data + start, end - start);
+  if (g && r->g &&
+      (g->nb_rows != r->g->nb_rows || g->nb_cols != r->g->nb_cols ||
+       g->wrapping != r->g->wrapping)) {
+    game_delete(g);
+    return NULL;
+  }
+  return g;
+}
+
+/* ************************************************************************** */
+
+game_replay game_replay_open(const char* filename) {
+  if (!filename) return NULL;
+  size_t size;
+  const uint8_t* p = _map_file(filename, REPLAY_HEADER, &size);
+  if (!p) return NULL;
+
+  uint interval = _get32(p + 8), n = _get32(p + 12);
+  uint64_t index = interval ? 8 * ((uint64_t)(n / interval) + 2) : 0;
+  uint64_t moves_end = REPLAY_HEADER + index + REPLAY_MOVE_SIZE * (uint64_t)n;
+  game_replay r = malloc(sizeof(struct game_replay_s));
+  if (!r || memcmp(p, REPLAY_MAGIC, 4) != 0 || p[4] != REPLAY_VERSION ||
+      interval == 0 || moves_end > size) {
+    free(r);
+    munmap((void*)p, size);
+    return NULL;
+  }
+  r->data = p;
+  r->size = size;
+  r->interval = interval;
+  r->nb_moves = n;
+  r->moves = p + REPLAY_HEADER + index;
+  r->g = NULL;
+  r->pos = 0;
+  r->g = _keyframe(r, 0);
+  if (!r->g) {
+    game_replay_close(r);
+    return NULL;
+  }
+  return r;
+}
+
+/* ************************************************************************** */
+
+uint game_replay_size(game_replay r) {
+  assert(r);
+  return r->nb_moves;
+}
+
+/* ************************************************************************** */
+
+uint game_replay_position(game_replay r) {
+  assert(r);
+  return r->pos;
+}
+
+/* ************************************************************************** */
+
+cgame game_replay_game(game_replay r) {
+  assert(r);
+  return r->g;
+}
+
+/* ************************************************************************** */
+
+/* play (forward) or take back the move at the cursor, with an incremental
+ * update of the flags */
+static bool _replay_step(game_replay r, bool forward) {
+  if (forward ? r->pos == r->nb_moves : r->pos == 0) return false;
+  uint k = forward ? r->pos : r->pos - 1;
+  const uint8_t* p = r->moves + REPLAY_MOVE_SIZE * (size_t)k;
+  uint i = _get16(p), j = _get16(p + 2);
+  square from = forward ? p[4] : p[5], to = forward ? p[5] : p[4];
+  game g = r->g;
+  if (i >= g->nb_rows || j >= g->nb_cols || to > S_MARK ||
+      STATE(g, i, j) != from)
+    return false;  // not a valid move from this board
+  SQUARE(g, i, j) = to;
+  _flags_touch(g, i, j);
+  r->pos = forward ? r->pos + 1 : r->pos - 1;
+  return true;
+}
+
+/* ************************************************************************** */
+
+bool game_replay_next(game_replay r) {
+  assert(r);
+  return _replay_step(r, true);
+}
+
+/* ************************************************************************** */
+
+bool game_replay_prev(game_replay r) {
+  assert(r);
+  return _replay_step(r, false);
+}
+
+/* ************************************************************************** */
+
+bool game_replay_seek(game_replay r, uint k) {
+  assert(r);
+  if (k > r->nb_moves) return false;
+  // start from the nearest keyframe, unless the board is nearer
+  uint key = (k + r->interval / 2) / r->interval;
+  if (key > r->nb_moves / r->interval) key = r->nb_moves / r->interval;
+  uint from_key = (k > key * r->interval) ? k - key * r->interval
+                                          : key * r->interval - k;
+  uint from_pos = (k > r->pos) ? k - r->pos : r->pos - k;
+  if (from_key < from_pos) {
+    game g = _keyframe(r, key);
+    if (!g) return false;
+    game_delete(r->g);
+    r->g = g;
+    r->pos = key * r->interval;
+  }
+  while (r->pos < k)
+    if (!_replay_step(r, true)) return false;
+  while (r->pos > k)
+    if (!_replay_step(r, false)) return false;
+  return true;
+}
+
+/* ************************************************************************** */
+
+void game_replay_close(game_replay r) {
+  if (!r) return;
+  if (r->g) game_delete(r->g);
+  munmap((void*)r->data, r->size);
+  free(r);
+}
+
+/* ************************************************************************** */
+/*                                SYMMETRIES                                  */
+/* ************************************************************************** */
+
+/** walk of the image of a game by a transform: the square (a,b) of the
+ * image is the square of index o+a*sa+b*sb in the game */
+typedef struct {
+  long o, sa, sb;
+  uint nb_rows, nb_cols; /**< size of the image */
+} walk;
+
+/* ************************************************************************** */
+
+static walk _walk(cgame g, transform t) {
+  long r = g->nb_rows, c = g->nb_cols;
+  switch (t) {
+    case T_ROTATE_90:
+      return (walk){(r - 1) * c, 1, -c, c, r};
+    case T_ROTATE_180:
+      return (walk){r * c - 1, -c, -1, r, c};
+    case T_ROTATE_270:
+      return (walk){c - 1, -1, c, c, r};
+    case T_FLIP_H:
+      return (walk){c - 1, c, -1, r, c};
+    case T_FLIP_V:
+      return (walk){(r - 1) * c, -c, 1, r, c};
+    case T_TRANSPOSE:
+      return (walk){0, 1, c, c, r};
+    case T_ANTITRANSPOSE:
+      return (walk){r * c - 1, -1, -c, c, r};
+    default:
+      return (walk){0, c, 1, r, c};
+  }
+}
+
+/* ************************************************************************** */
+
+/* coordinates in the image by a transform of the square (i,j) of a game */
+static move _image_move(cgame g, transform t, move m) {
+  uint r = g->nb_rows, c = g->nb_cols, i = m.i, j = m.j;
+  uint ii[] = {[T_IDENTITY] = i,         [T_ROTATE_90] = j,
+               [T_ROTATE_180] = r - 1 - i, [T_ROTATE_270] = c - 1 - j,
+               [T_FLIP_H] = i,           [T_FLIP_V] = r - 1 - i,
+               [T_TRANSPOSE] = j,        [T_ANTITRANSPOSE] = c - 1 - j};
+  uint jj[] = {[T_IDENTITY] = j,         [T_ROTATE_90] = r - 1 - i,
+               [T_ROTATE_180] = c - 1 - j, [T_ROTATE_270] = i,
+               [T_FLIP_H] = c - 1 - j,   [T_FLIP_V] = j,
+               [T_TRANSPOSE] = i,        [T_ANTITRANSPOSE] = r - 1 - i};
+  m.i = ii[t];
+  m.j = jj[t];
+  return m;
+}
+
+/* ************************************************************************** */
+
+void game_transform(game g, transform t) {
+  assert(g && t < NB_TRANSFORMS);
+  _flags_resolve(g);  // the pending squares are not transformed
+  walk w = _walk(g, t);
+  square* squares = malloc(w.nb_rows * w.nb_cols * sizeof(square));
+  assert(squares);
+  for (uint a = 0; a < w.nb_rows; a++)
+    for (uint b = 0; b < w.nb_cols; b++)
+      squares[a * w.nb_cols + b] = g->squares[w.o + a * w.sa + b * w.sb];
+  // the history follows, so that undo and redo still work
+  for (uint k = 0; k < g->nb_moves; k++)
+    g->history[k] = _image_move(g, t, g->history[k]);
+  if (g->owned) free(g->squares);
+  g->squares = squares;
+  g->owned = true;
+  g->nb_rows = w.nb_rows;
+  g->nb_cols = w.nb_cols;
+  // the flags are unchanged by symmetry, but a journal must be rewritten
+  g->cleared = true;
+  if (g->journal) _journal_append(g);
+}
+
+/* ************************************************************************** */
+
+/* state of the square of index k, or only its wall if walls is true */
+static square _state(cgame g, long k, bool walls) {
+  square s = g->squares[k] & S_MASK;
+  return (walls && !(s & S_BLACK)) ? S_BLANK : s;
+}
+
+/* ************************************************************************** */
+
+/* transform that gives the canonical image of a game, or of its walls */
+static transform _canonical(cgame g, bool walls) {
+  // the images with the fewest rows first, then the lexicographically
+  // smallest states: candidates are dropped as soon as they are larger, so
+  // that all of them are rarely scanned to the end
+  walk w[NB_TRANSFORMS];
+  uint alive = 0;  // bit set of candidates
+  uint nb_rows = g->nb_rows < g->nb_cols ? g->nb_rows : g->nb_cols;
+  for (uint t = 0; t < NB_TRANSFORMS; t++) {
+    w[t] = _walk(g, t);
+    if (w[t].nb_rows == nb_rows) alive |= 1u << t;
+  }
+  uint nb_cols = g->nb_rows * g->nb_cols / nb_rows;
+  for (uint a = 0; a < nb_rows; a++)
+    for (uint b = 0; b < nb_cols; b++) {
+      if ((alive & (alive - 1)) == 0) goto done;  // a single candidate
+      square s[NB_TRANSFORMS], min = S_MASK;
+      for (uint t = 0; t < NB_TRANSFORMS; t++)
+        if (alive & (1u << t)) {
+          s[t] = _state(g, w[t].o + a * w[t].sa + b * w[t].sb, walls);
+          if (s[t] < min) min = s[t];
+        }
+      for (uint t = 0; t < NB_TRANSFORMS; t++)
+        if ((alive & (1u << t)) && s[t] > min) alive &= ~(1u << t);
+    }
+done:
+  for (uint t = 0; t < NB_TRANSFORMS; t++)
+    if (alive & (1u << t)) return t;
+  return T_IDENTITY;  // not reached
+}
+
+/* ************************************************************************** */
+
+transform game_canonical_transform(cgame g) {
+  assert(g);
+  return _canonical(g, false);
+}
+
+/* ************************************************************************** */
+
+/* FNV-1a hash of the image of a game by a transform */
+static uint64_t _hash_image(cgame g, transform t, bool walls) {
+  walk w = _walk(g, t);
+  uint64_t h = 0xCBF29CE484222325ULL;
+  uint64_t head[3] = {w.nb_rows, w.nb_cols, g->wrapping};
+  for (uint k = 0; k < 3; k++) h = (h ^ head[k]) * 0x100000001B3ULL;
+  for (uint a = 0; a < w.nb_rows; a++)
+    for (uint b = 0; b < w.nb_cols; b++)
+      h = (h ^ _state(g, w.o + a * w.sa + b * w.sb, walls)) * 0x100000001B3ULL;
+  return h;
+}
+
+/* ************************************************************************** */
+
+uint64_t game_canonical_hash(cgame g) {
+  assert(g);
+  return _hash_image(g, _canonical(g, false), false);
+}
+
+/* ************************************************************************** */
+/*                              SOLUTION CACHE                                */
+/* ************************************************************************** */
+
+/* header: magic, version, 3 zero bytes, number of slots (a power of 2), then
+ * the slots, in the byte order of the machine */
+#define CACHE_MAGIC "LUPC"
+#define CACHE_VERSION 1
+#define CACHE_HEADER 64
+#define CACHE_PROBES 16          /* slots tried for a key */
+#define CACHE_MAX_CELLS 384      /* largest game cached */
+#define CACHE_UNKNOWN 0xFFFFFFFF /* count: a solution, but not counted */
+
+/** solution of a puzzle, written under a sequence lock: readers retry or
+ * give up if the sequence is odd or changed while they read */
+typedef struct {
+  uint32_t seq;   /**< 0 if empty, odd while written, even otherwise */
+  uint32_t count; /**< number of solutions, or CACHE_UNKNOWN */
+  uint64_t key;   /**< canonical hash of the walls */
+  uint64_t bits[CACHE_MAX_CELLS / 64]; /**< light bulbs of a solution, in the
+                                          canonical image */
+} cache_slot;
+
+/** cache opened by the process */
+static struct {
+  pthread_mutex_t lock; /**< writers of the process */
+  int fd;               /**< cache file, locked by writers of all processes */
+  cache_slot* slots;    /**< mapped slots, NULL if no cache is open */
+  uint nb_slots;        /**< number of slots */
+  size_t size;          /**< size of the mapping */
+} cache = {PTHREAD_MUTEX_INITIALIZER, -1, NULL, 0, 0};
+
+/* ************************************************************************** */
+
+/* lock or unlock the cache file for the writers of all processes */
+static bool _lock_file(int fd, bool lock) {
+  struct flock fl = {0};
+  fl.l_type = lock ? F_WRLCK : F_UNLCK;
+  fl.l_whence = SEEK_SET;
+  fl.l_len = CACHE_HEADER;
+  return fcntl(fd, F_SETLKW, &fl) == 0;
+}
+
+/* ************************************************************************** */
+
+game_error game_cache_open(const char* filename, uint nb_slots) {
+  if (!filename) return GAME_ERR_PARAM;
+  game_cache_close();
+  uint n = CACHE_PROBES;
+  while (n < nb_slots && n < (1u << 30)) n *= 2;
+  int fd = open(filename, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return GAME_ERR_IO;
+  if (!_lock_file(fd, true)) {
+    close(fd);
+    return GAME_ERR_IO;
+  }
+
+  // create the file, or check its header
+  game_error err = GAME_OK;
+  uint8_t header[CACHE_HEADER] = {0};
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    err = GAME_ERR_IO;
+  } else if (st.st_size == 0) {
+    memcpy(header, CACHE_MAGIC, 4);
+    header[4] = CACHE_VERSION;
+    _put32(header + 8, n);
+    if (ftruncate(fd, CACHE_HEADER + (off_t)n * sizeof(cache_slot)) != 0 ||
+        pwrite(fd, header, CACHE_HEADER, 0) != CACHE_HEADER)
+      err = GAME_ERR_IO;
+  } else if (st.st_size < CACHE_HEADER) {
+    err = GAME_ERR_FORMAT;
+  } else {
+    if (pread(fd, header, CACHE_HEADER, 0) != CACHE_HEADER)
+      err = GAME_ERR_IO;
+    else if (memcmp(header, CACHE_MAGIC, 4) != 0 ||
+             header[4] != CACHE_VERSION)
+      err = GAME_ERR_FORMAT;
+    n = _get32(header + 8);
+    if (err == GAME_OK && (n < CACHE_PROBES || (n & (n - 1)) != 0 ||
+                           (uint64_t)st.st_size !=
+                               CACHE_HEADER + (uint64_t)n * sizeof(cache_slot)))
+      err = GAME_ERR_FORMAT;
+  }
+  size_t size = CACHE_HEADER + (size_t)n * sizeof(cache_slot);
+  void* data = MAP_FAILED;
+  if (err == GAME_OK)
+    data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  _lock_file(fd, false);
+  if (err == GAME_OK && data == MAP_FAILED) err = GAME_ERR_IO;
+  if (err != GAME_OK) {
+    close(fd);
+    return err;
+  }
+  cache.fd = fd;
+  cache.slots = (cache_slot*)((uint8_t*)data + CACHE_HEADER);
+  cache.nb_slots = n;
+  cache.size = size;
+  return GAME_OK;
+}
+
+/* ************************************************************************** */
+
+void game_cache_close(void) {
+  if (!cache.slots) return;
+  munmap((uint8_t*)cache.slots - CACHE_HEADER, cache.size);
+  close(cache.fd);
+  cache.slots = NULL;
+  cache.fd = -1;
+}
+
+/* ************************************************************************** */
+
+/* look for the solution of the puzzle of key h, return false if not found */
+static bool _cache_get(uint64_t h, cache_slot* out) {
+  for (uint k = 0; k < CACHE_PROBES; k++) {
+    cache_slot* slot = &cache.slots[(h + k) & (cache.nb_slots - 1)];
+    uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    if (seq == 0) return false;  // end of the probe sequence
+    if (seq & 1) continue;       // being written
+    // acquire loads: the sequence is read again after the data
+    out->key = __atomic_load_n(&slot->key, __ATOMIC_ACQUIRE);
+    out->count = __atomic_load_n(&slot->count, __ATOMIC_ACQUIRE);
+    for (uint b = 0; b < CACHE_MAX_CELLS / 64; b++)
+      out->bits[b] = __atomic_load_n(&slot->bits[b], __ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq) continue;
+    if (out->key == h) return true;
+  }
+  return false;
+}
+
+/* ************************************************************************** */
+
+/* store the solution of the puzzle of key h, in the first slot that has the
+ * same key, or is empty, or else in the home slot of the key (no age is kept,
+ * the entry there is evicted) */
+static void _cache_put(uint64_t h, const cache_slot* in) {
+  pthread_mutex_lock(&cache.lock);
+  if (_lock_file(cache.fd, true)) {
+    cache_slot* slot = &cache.slots[h & (cache.nb_slots - 1)];
+    for (uint k = 0; k < CACHE_PROBES; k++) {
+      cache_slot* s = &cache.slots[(h + k) & (cache.nb_slots - 1)];
+      if (s->seq == 0 || s->key == h) {
+        slot = s;
+        break;
+      }
+    }
+    uint32_t seq = slot->seq;
+    // release stores: the odd sequence is written before the data
+    __atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->key, h, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot->count, in->count, __ATOMIC_RELEASE);
+    for (uint b = 0; b < CACHE_MAX_CELLS / 64; b++)
+      __atomic_store_n(&slot->bits[b], in->bits[b], __ATOMIC_RELEASE);
+    __atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+    _lock_file(cache.fd, false);
+  }
+  pthread_mutex_unlock(&cache.lock);
+}
+
+/* ************************************************************************** */
+
+/* key of a game in the cache (0 if it can't be cached), and the transform
+ * that gives the canonical image of its walls */
+static uint64_t _cache_key(cgame g, transform* t) {
+  if (!cache.slots || g->nb_rows * g->nb_cols > CACHE_MAX_CELLS) return 0;
+  *t = _canonical(g, true);
+  uint64_t h = _hash_image(g, *t, true);
+  return h ? h : 1;
+}
+
+/* ************************************************************************** */
+
+/* store the solution found by a solver */
+static void _cache_store(cgame g, uint64_t h, transform t, const solver* s,
+                         uint count) {
+  cache_slot slot = {0, count, h, {0}};
+  walk w = _walk(g, t);
+  if (count > 0)
+    for (uint a = 0, p = 0; a < w.nb_rows; a++)
+      for (uint b = 0; b < w.nb_cols; b++, p++)
+        if (s->best[w.o + a * w.sa + b * w.sb] == V_BULB)
+          slot.bits[p / 64] |= 1ULL << (p % 64);
+  _cache_put(h, &slot);
+}
+
+/* ************************************************************************** */
+
+/* play a cached solution on g, if it solves g */
+static bool _cache_apply(game g, transform t, const cache_slot* slot) {
+  game gg = game_copy(g);
+  walk w = _walk(g, t);
+  for (uint a = 0, p = 0; a < w.nb_rows; a++)
+    for (uint b = 0; b < w.nb_cols; b++, p++) {
+      long k = w.o + a * w.sa + b * w.sb;
+      if (gg->squares[k] & S_BLACK) continue;
+      bool bulb = (slot->bits[p / 64] >> (p % 64)) & 1;
+      gg->squares[k] = bulb ? S_LIGHTBULB : S_BLANK;
+    }
+  game_update_flags(gg);
+  bool ok = game_is_over(gg);  // also detects a collision of hashes
+  if (ok) {
+    _own_squares(g);
+    memcpy(g->squares, gg->squares,
+           g->nb_rows * g->nb_cols * sizeof(square));
+  }
+  game_delete(gg);
+  return ok;
+}
+
+/* ************************************************************************** */
+/*                                  SOLVER                                    */
+/* ************************************************************************** */
+
+/* copy the first solution found by the solver into the game */
+static void _apply_solution(game g, const solver* s, bool keep_marks) {
+  _own_squares(g);
+  for (uint c = 0; c < s->nb_cells; c++) {
+    if (s->wall_of[c] != NONE) continue;
+    if (s->best[c] == V_BULB)
+      g->squares[c] = S_LIGHTBULB;
+    else if (!keep_marks || (g->squares[c] & S_MASK) != S_MARK)
+      g->squares[c] = S_BLANK;
+  }
+  _flags_compute(g);
+}
+
+/* ************************************************************************** */
+
+/* solve under the given assumptions, or compute a subset of them that
+ * conflicts (kept in the same order as in cells) */
+static bool _solve_assuming(solver* s, cgame g, const uint* cells, uint n,
+                            uint* core, uint* nb_core) {
+  solver_undo(s, 0);
+  bool ok = true;
+  for (uint k = 0; ok && k < n; k++) {
+    square st = g->squares[cells[k]] & S_MASK;
+    ok = solver_assume(s, cells[k], st == S_LIGHTBULB ? V_BULB : V_EMPTY);
+  }
+  if (ok) ok = solver_propagate(s);
+  if (ok) {
+    if (solver_search(s, 1) > 0) return true;
+    if (n) memcpy(core, cells, n * sizeof(uint));  // cells may be NULL
+    *nb_core = n;
+    return false;
+  }
+  uint m = solver_explain(s, core);
+  memset(s->seen, 0, s->nb_cells);
+  for (uint k = 0; k < m; k++) s->seen[core[k]] = 1;
+  *nb_core = 0;
+  for (uint k = 0; k < n; k++)
+    if (s->seen[cells[k]]) core[(*nb_core)++] = cells[k];
+  return false;
+}
+
+/* ************************************************************************** */
+
+bool game_solve(game g) {
+  assert(g);
+  transform t = T_IDENTITY;
+  uint64_t h = _cache_key(g, &t);
+  cache_slot slot;
+  if (h && _cache_get(h, &slot)) {
+    if (slot.count == 0) return false;
+    if (_cache_apply(g, t, &slot)) return true;
+  }
+  solver* s = solver_new(g);
+  bool solved = (solver_search(s, 1) > 0);
+  if (solved) _apply_solution(g, s, false);
+  if (h) _cache_store(g, h, t, s, solved ? CACHE_UNKNOWN : 0);
+  solver_delete(s);
+  return solved;
+}
+
+/* ************************************************************************** */
+
+uint game_nb_solutions(game g) {
+  assert(g);
+  transform t = T_IDENTITY;
+  uint64_t h = _cache_key(g, &t);
+  cache_slot slot;
+  if (h && _cache_get(h, &slot) && slot.count != CACHE_UNKNOWN)
+    return slot.count;
+  solver* s = solver_new(g);
+  uint nb = solver_search(s, UINT_MAX);
+  if (h) _cache_store(g, h, t, s, nb < CACHE_UNKNOWN ? nb : CACHE_UNKNOWN - 1);
+  solver_delete(s);
+  return nb;
+}
+
+/* ************************************************************************** */
+
+bool game_solve_from_position(game g, uint* conflicts, uint* nb_conflicts) {
+  assert(g);
+  solver* s = solver_new(g);
+  uint size = s->nb_cells;
+  uint* moves = malloc((size + 1) * sizeof(uint));
+  uint* core = malloc((size + 1) * sizeof(uint));
+  uint* trial = malloc((size + 1) * sizeof(uint));
+  assert(moves && core && trial);
+
+  // light bulbs and marks played so far are the assumptions
+  uint n = 0;
+  for (uint c = 0; c < size; c++) {
+    square st = g->squares[c] & S_MASK;
+    if (st == S_LIGHTBULB || st == S_MARK) moves[n++] = c;
+  }
+
+  uint nb_core = 0, nb_none = 0;
+  bool solved = _solve_assuming(s, g, moves, n, core, &nb_core);
+  if (solved) {
+    _apply_solution(g, s, true);
+    nb_core = 0;
+  } else if (nb_core > 0 &&
+             !_solve_assuming(s, g, NULL, 0, trial, &nb_none)) {
+    nb_core = 0;  // the puzzle itself has no solution
+  } else {
+    // deletion-based minimisation: drop every move not needed for the
+    // conflict, the ones kept before index k being necessary
+    uint k = 0;
+    while (k < nb_core) {
+      uint m = 0;
+      for (uint l = 0; l < nb_core; l++)
+        if (l != k) trial[m++] = core[l];
+      uint nb_sub = 0;
+      if (_solve_assuming(s, g, trial, m, core, &nb_sub))
+        k++;  // core[k] is necessary, core is left unchanged
+      else
+        nb_core = nb_sub;
+    }
+  }
+
+  if (conflicts) memcpy(conflicts, core, nb_core * sizeof(uint));
+  if (nb_conflicts) *nb_conflicts = nb_core;
+  free(trial);
+  free(core);
+  free(moves);
+  solver_delete(s);
+  return solved;
+}
+
+/* ************************************************************************** */
+
+/* ************************************************************************** */
+/*                                  HINTS                                     */
+/* ************************************************************************** */
+
+static bool _set_hint(const solver* s, hint* h, uint c, value v, hint_rule r,
+                      uint at) {
+  h->i = c / s->nb_cols;
+  h->j = c % s->nb_cols;
+  h->s = (v == V_BULB) ? S_LIGHTBULB : S_MARK;
+  h->rule = r;
+  h->ri = at / s->nb_cols;
+  h->rj = at % s->nb_cols;
+  return true;
+}
+
+/* ************************************************************************** */
+
+/* first unknown square around a wall */
+static uint _wall_unknown(const solver* s, uint w) {
+  for (uint d = 0; d < 4; d++) {
+    uint y = s->wall_neigh[4 * w + d];
+    if (y != NONE && s->val[y] == V_UNKNOWN) return y;
+  }
+  return NONE;
+}
+
+/* ************************************************************************** */
+
+/* look for the simplest forced move on a propagated position */
+static bool _find_hint(solver* s, hint* h) {
+  // 1) walls with all their light bulbs, 2) with just enough free squares
+  for (uint w = 0; w < s->nb_walls; w++) {
+    int k = s->wall_num[w], b = s->wall_bulbs[w];
+    if (k >= 0 && s->wall_free[w] > 0 && b == k)
+      return _set_hint(s, h, _wall_unknown(s, w), V_EMPTY, H_WALL_FULL,
+                       s->wall_cell[w]);
+  }
+  for (uint w = 0; w < s->nb_walls; w++) {
+    int k = s->wall_num[w], b = s->wall_bulbs[w], f = s->wall_free[w];
+    if (k >= 0 && f > 0 && b + f == k)
+      return _set_hint(s, h, _wall_unknown(s, w), V_BULB, H_WALL_FREE,
+                       s->wall_cell[w]);
+  }
+
+  // 3) unlit squares with a single candidate
+  for (uint x = 0; x < s->nb_cells; x++) {
+    if (s->wall_of[x] != NONE || solver_is_lit(s, x)) continue;
+    if (solver_nb_candidates(s, x) != 1) continue;
+    for (uint d = 0; d < 2; d++) {
+      uint seg = s->seg[d][x];
+      for (uint k = s->seg_first[seg]; k < s->seg_first[seg + 1]; k++)
+        if (s->val[s->seg_cells[k]] == V_UNKNOWN)
+          return _set_hint(s, h, s->seg_cells[k], V_BULB, H_SINGLE, x);
+    }
+  }
+
+  // 4) squares where a light bulb leads to a contradiction
+  for (uint y = 0; y < s->nb_cells; y++) {
+    if (s->val[y] != V_UNKNOWN) continue;
+    uint mark = s->trail_len;
+    solver_assume(s, y, V_BULB);
+    bool ok = solver_propagate(s);
+    solver_undo(s, mark);
+    if (ok) continue;
+    uint at = s->confl_id;
+    if (s->confl_rule == R_WALL_FULL) at = s->wall_cell[at];
+    return _set_hint(s, h, y, V_EMPTY, H_EXCLUSION, at);
+  }
+
+  return false;
+}
+
+/* ************************************************************************** */
+
+/* collect all the moves forced by the simplest rules that apply */
+static uint _collect_moves(solver* s, uint* cells, uint8_t* vals,
+                           hint_rule* rules) {
+  uint n = 0;
+  for (uint w = 0; w < s->nb_walls; w++) {
+    int k = s->wall_num[w], b = s->wall_bulbs[w], f = s->wall_free[w];
+    if (k < 0 || f == 0 || (b != k && b + f != k)) continue;
+    for (uint d = 0; d < 4; d++) {
+      uint y = s->wall_neigh[4 * w + d];
+      if (y == NONE || s->val[y] != V_UNKNOWN) continue;
+      cells[n] = y;
+      vals[n] = (b == k) ? V_EMPTY : V_BULB;
+      rules[n++] = (b == k) ? H_WALL_FULL : H_WALL_FREE;
+    }
+  }
+  for (uint x = 0; x < s->nb_cells; x++) {
+    if (s->wall_of[x] != NONE || solver_is_lit(s, x)) continue;
+    if (solver_nb_candidates(s, x) != 1) continue;
+    for (uint d = 0; d < 2; d++) {
+      uint seg = s->seg[d][x];
+      for (uint k = s->seg_first[seg]; k < s->seg_first[seg + 1]; k++)
+        if (s->val[s->seg_cells[k]] == V_UNKNOWN) {
+          cells[n] = s->seg_cells[k];
+          vals[n] = V_BULB;
+          rules[n++] = H_SINGLE;
+        }
+    }
+  }
+  if (n > 0) return n;
+  for (uint y = 0; y < s->nb_cells; y++) {
+    if (s->val[y] != V_UNKNOWN) continue;
+    uint mark = s->trail_len;
+    solver_assume(s, y, V_BULB);
+    bool ok = solver_propagate(s);
+    solver_undo(s, mark);
+    if (ok) continue;
+    cells[n] = y;
+    vals[n] = V_EMPTY;
+    rules[n++] = H_EXCLUSION;
+  }
+  return n;
+}
+
+/* ************************************************************************** */
+
+/** solver kept from one hint to the next */
+struct game_hinter_s {
+  solver* s;      /**< solver built from the walls, NULL if none yet */
+  square* states; /**< state of each square at the last sync */
+  uint* moves;    /**< assumed squares, in the order of the trail */
+  uint* marks;    /**< trail length before each assumed square */
+  uint* rank;     /**< index of each square in moves, NONE if not assumed */
+  uint nb_moves;  /**< number of assumed squares */
+};
+
+/* ************************************************************************** */
+
+game_hinter game_hinter_new(void) {
+  game_hinter hc = calloc(1, sizeof(struct game_hinter_s));
+  assert(hc);
+  return hc;
+}
+
+/* ************************************************************************** */
+
+void game_hinter_delete(game_hinter hc) {
+  if (!hc) return;
+  solver_delete(hc->s);
+  free(hc->states);
+  free(hc->moves);
+  free(hc->marks);
+  free(hc->rank);
+  free(hc);
+}
+
+/* ************************************************************************** */
+
+/* forget all the moves, keeping the segment structure */
+static void _hinter_reset(game_hinter hc) {
+  solver* s = hc->s;
+  solver_undo(s, 0);
+  for (uint c = 0; c < s->nb_cells; c++) {
+    if (s->wall_of[c] == NONE) hc->states[c] = S_BLANK;
+    hc->rank[c] = NONE;
+  }
+  hc->nb_moves = 0;
+}
+
+/* ************************************************************************** */
+
+/* rebuild the solver from the walls of g */
+static void _hinter_build(game_hinter hc, cgame g) {
+  uint n = g->nb_rows * g->nb_cols;
+  solver_delete(hc->s);
+  hc->s = solver_new(g);
+  hc->s->rules = 0;  // only light bulbs emptying their segments
+  hc->states = realloc(hc->states, n * sizeof(square));
+  hc->moves = realloc(hc->moves, n * sizeof(uint));
+  hc->marks = realloc(hc->marks, n * sizeof(uint));
+  hc->rank = realloc(hc->rank, n * sizeof(uint));
+  assert(hc->states && hc->moves && hc->marks && hc->rank);
+  for (uint c = 0; c < n; c++) hc->states[c] = g->squares[c] & S_MASK;
+  _hinter_reset(hc);
+}
+
+/* ************************************************************************** */
+
+/* assume a move on top of the trail, propagated so that undoing back to its
+ * mark restores the propagated state of the previous moves */
+static bool _hinter_assume(game_hinter hc, uint c) {
+  value v = (hc->states[c] == S_LIGHTBULB) ? V_BULB : V_EMPTY;
+  hc->marks[hc->nb_moves] = hc->s->trail_len;
+  hc->rank[c] = hc->nb_moves;
+  hc->moves[hc->nb_moves++] = c;
+  return solver_assume(hc->s, c, v) && solver_propagate(hc->s);
+}
+
+/* ************************************************************************** */
+
+/* bring the assumptions of the solver up to date with the squares of g */
+static bool _hinter_sync(game_hinter hc, cgame g) {
+  solver* s = hc->s;
+  uint n = g->nb_rows * g->nb_cols;
+  if (!s || s->nb_rows != g->nb_rows || s->nb_cols != g->nb_cols ||
+      s->wrapping != g->wrapping) {
+    _hinter_build(hc, g);
+    s = hc->s;
+  }
+
+  // oldest removed move, walls changed
+  uint first = hc->nb_moves;
+  for (uint c = 0; c < n; c++) {
+    square st = g->squares[c] & S_MASK;
+    if (st == hc->states[c]) continue;
+    if ((st & S_BLACK) || (hc->states[c] & S_BLACK)) {
+      _hinter_build(hc, g);
+      return _hinter_sync(hc, g);
+    }
+    if (hc->rank[c] != NONE && hc->rank[c] < first) first = hc->rank[c];
+  }
+
+  // undo back to the oldest removed move, then replay the moves kept
+  uint nb = hc->nb_moves;
+  if (first < nb) solver_undo(s, hc->marks[first]);
+  hc->nb_moves = first;
+  bool ok = true;
+  for (uint k = first; k < nb; k++) {
+    uint c = hc->moves[k];
+    hc->rank[c] = NONE;
+    if ((g->squares[c] & S_MASK) == hc->states[c] && ok)
+      ok = _hinter_assume(hc, c);
+  }
+  for (uint c = 0; c < n; c++) {
+    square st = g->squares[c] & S_MASK;
+    if (st == hc->states[c]) continue;
+    hc->states[c] = st;
+    if (ok && (st == S_LIGHTBULB || st == S_MARK)) ok = _hinter_assume(hc, c);
+  }
+  if (ok) ok = solver_propagate(s);
+
+  // a mistake: the next call starts again from an empty trail
+  if (!ok) _hinter_reset(hc);
+  return ok;
+}
+
+/* ************************************************************************** */
+
+bool game_hinter_next(game_hinter hc, cgame g, hint* h) {
+  assert(hc && g && h);
+  bool ok = _hinter_sync(hc, g) && _find_hint(hc->s, h);
+  if (!ok) h->rule = H_NONE;
+  return ok;
+}
+
+/* ************************************************************************** */
+
+bool game_hint(cgame g, hint* h) {
+  assert(g && h);
+  game_hinter hc = game_hinter_new();
+  bool ok = game_hinter_next(hc, g, h);
+  game_hinter_delete(hc);
+  return ok;
+}
+
+/* ************************************************************************** */
+
+grade game_grade(cgame g) {
+  assert(g);
+  grade r;
+  memset(&r, 0, sizeof(grade));
+  solver* s = solver_new(g);
+  uint size = s->nb_cells;
+  uint* cells = malloc((4 * size + 1) * sizeof(uint));
+  uint8_t* vals = malloc(4 * size + 1);
+  hint_rule* rules = malloc((4 * size + 1) * sizeof(hint_rule));
+  assert(cells && vals && rules);
+
+  // deduction rounds, with light bulbs emptying their segments in between
+  s->rules = 0;
+  bool ok = solver_propagate(s);
+  while (ok) {
+    uint n = _collect_moves(s, cells, vals, rules);
+    if (n == 0) break;
+    r.nb_rounds++;
+    for (uint k = 0; ok && k < n; k++) {
+      if (s->val[cells[k]] == vals[k]) continue;  // already forced
+      ok = solver_assume(s, cells[k], vals[k]);
+      r.nb_moves[rules[k]]++;
+      if (rules[k] > r.hardest) r.hardest = rules[k];
+    }
+    if (ok) ok = solver_propagate(s);
+  }
+
+  // search for the rest
+  if (ok) {
+    s->rules = RULES_ALL;
+    uint nb = solver_search(s, 2);
+    r.solvable = (nb > 0);
+    r.unique = (nb == 1);
+    r.nb_guesses = s->nb_nodes - 1;
+  }
+
+  r.score = r.nb_moves[H_WALL_FULL] + r.nb_moves[H_WALL_FREE] +
+            2 * r.nb_moves[H_SINGLE] + 4 * r.nb_moves[H_EXCLUSION] +
+            10 * r.nb_guesses;
+  free(rules);
+  free(vals);
+  free(cells);
+  solver_delete(s);
+  return r;
+}
+
+/* ************************************************************************** */
+
+/* ************************************************************************** */
+/*                                MINIMISER                                   */
+/* ************************************************************************** */
+
+/** trial of the removal of a wall number */
+typedef struct {
+  solver* s;      /**< solver used by the trial */
+  uint w;         /**< wall index */
+  bool unique;    /**< solution still unique without the number */
+} trial;
+
+/* ************************************************************************** */
+
+static void* _try_removal(void* arg) {
+  trial* t = arg;
+  int num = t->s->wall_num[t->w];
+  solver_set_wall(t->s, t->w, -1);
+  t->unique = (solver_search(t->s, 2) == 1);
+  solver_set_wall(t->s, t->w, num);
+  return NULL;
+}
+
+/* ************************************************************************** */
+
+/* remove wall numbers in the given order while the solution stays unique,
+ * with nb solvers of the same game running trials in parallel. A number that
+ * can't be removed never can once other numbers are gone, so in each batch
+ * only the trials after the first removal have to be run again. */
+static void _remove_clues(solver** s, uint nb, uint* order, uint n) {
+  trial* t = malloc(nb * sizeof(trial));
+  pthread_t* th = malloc(nb * sizeof(pthread_t));
+  bool* started = calloc(nb, sizeof(bool));
+  assert(t && th && started);
+
+  uint k = 0;
+  while (k < n) {
+    uint m = (n - k < nb) ? n - k : nb;
+    for (uint l = 0; l < m; l++) t[l] = (trial){s[l], order[k + l], false};
+    for (uint l = 1; l < m; l++)
+      started[l] = (pthread_create(&th[l], NULL, _try_removal, &t[l]) == 0);
+    _try_removal(&t[0]);
+    for (uint l = 1; l < m; l++) {
+      if (started[l])
+        pthread_join(th[l], NULL);
+      else
+        _try_removal(&t[l]);  // no thread available
+    }
+
+    // keep the first removal, and try again the next successful ones
+    uint f = 0;
+    while (f < m && !t[f].unique) f++;
+    if (f < m)
+      for (uint l = 0; l < nb; l++) solver_set_wall(s[l], t[f].w, -1);
+    uint r = k + m;
+    for (uint l = m - 1; l > f; l--)
+      if (t[l].unique) order[--r] = t[l].w;
+    k = r;
+  }
+
+  free(started);
+  free(th);
+  free(t);
+}
+
+/* ************************************************************************** */
+
+/* number of ways to put the light bulbs of a wall number (7 if the wall has
+ * no neighbour), weaker numbers being removed first */
+static uint _nb_ways(const solver* s, uint w) {
+  uint n = 0;
+  for (uint k = 0; k < 4; k++) n += (s->wall_neigh[4 * w + k] != NONE);
+  if (n == 0) return 7;
+  uint k = s->wall_num[w], ways = 1;
+  for (uint l = 0; l < k; l++) ways = ways * (n - l) / (l + 1);
+  return ways;
+}
+
+/* ************************************************************************** */
+
+uint game_minimize_clues(game g, uint nb_threads) {
+  assert(g);
+  if (nb_threads == 0) nb_threads = 1;
+  solver** s = malloc(nb_threads * sizeof(solver*));
+  assert(s);
+  s[0] = solver_new(g);
+  uint nb_walls = s[0]->nb_walls, removed = 0;
+  if (solver_search(s[0], 2) != 1) {
+    solver_delete(s[0]);
+    free(s);
+    return 0;
+  }
+  for (uint l = 1; l < nb_threads; l++) s[l] = solver_new(g);
+
+  // numbered walls, weakest numbers first (stable counting sort)
+  uint* order = malloc((nb_walls + 1) * sizeof(uint));
+  assert(order);
+  uint n = 0;
+  for (uint ways = 7; ways > 0; ways--)
+    for (uint w = 0; w < nb_walls; w++)
+      if (s[0]->wall_num[w] >= 0 && _nb_ways(s[0], w) == ways) order[n++] = w;
+
+  _remove_clues(s, nb_threads, order, n);
+  _own_squares(g);
+  for (uint w = 0; w < nb_walls; w++) {
+    uint c = s[0]->wall_cell[w];
+    if (s[0]->wall_num[w] < 0 && (g->squares[c] & S_MASK) != S_BLACKU) {
+      g->squares[c] = S_BLACKU;
+      removed++;
+    }
+  }
+  _flags_compute(g);
+
+  free(order);
+  for (uint l = 0; l < nb_threads; l++) solver_delete(s[l]);
+  free(s);
+  return removed;
+}
+
+/* ************************************************************************** */
+/*                                GENERATOR                                   */
+/* ************************************************************************** */
+
+/** maximum number of wall moves tried by the generator */
+#define MAX_ATTEMPTS 256
+
+/* ************************************************************************** */
+
+/* splitmix64: a small generator whose whole state is a 64-bit seed */
+static uint64_t _rand_next(uint64_t* state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/* ************************************************************************** */
+
+static void _shuffle(uint* t, uint n, uint64_t* state) {
+  for (uint k = n; k > 1; k--) {
+    uint l = _rand_next(state) % k;
+    uint tmp = t[k - 1];
+    t[k - 1] = t[l];
+    t[l] = tmp;
+  }
+}
+
+/* ************************************************************************** */
+
+/* light the grid with light bulbs put on random unlit squares, the light
+ * bulbs already in g being tried first, then number the walls accordingly */
+static void _random_solution(game g, uint* order, uint64_t* state) {
+  solver* s = solver_new(g);
+  s->rules = 0;
+  uint n = 0, m = 0;
+  for (uint c = 0; c < s->nb_cells; c++)
+    if (g->squares[c] == S_LIGHTBULB) order[n++] = c;
+  _shuffle(order, n, state);
+  for (uint c = 0; c < s->nb_cells; c++)
+    if (s->wall_of[c] == NONE && g->squares[c] != S_LIGHTBULB)
+      order[n + m++] = c;
+  _shuffle(order + n, m, state);
+  for (uint k = 0; k < n + m; k++) {
+    if (s->val[order[k]] != V_UNKNOWN) continue;
+    solver_assume(s, order[k], V_BULB);
+    solver_propagate(s);
+  }
+  for (uint c = 0; c < s->nb_cells; c++)
+    if (s->wall_of[c] == NONE)
+      g->squares[c] = (s->val[c] == V_BULB) ? S_LIGHTBULB : S_BLANK;
+  for (uint w = 0; w < s->nb_walls; w++)
+    g->squares[s->wall_cell[w]] = S_BLACK + s->wall_bulbs[w];
+  solver_delete(s);
+}
+
+/* ************************************************************************** */
+
+/* search a solution other than the light bulbs of g, and return a square
+ * where it has a light bulb and g has not (NONE if the solution is unique) */
+static uint _other_solution(game g, solver* s) {
+  if (solver_search(s, 2) < 2) return NONE;
+  bool other = false;
+  for (uint c = 0; c < s->nb_cells; c++)
+    if ((s->best[c] == V_BULB) != (g->squares[c] == S_LIGHTBULB)) other = true;
+  // the first solution is the one of g: find another one without one bulb
+  for (uint c = 0; !other && c < s->nb_cells; c++) {
+    if (g->squares[c] != S_LIGHTBULB) continue;
+    if (solver_assume(s, c, V_EMPTY) && solver_propagate(s))
+      other = (solver_search(s, 1) == 1);
+    solver_undo(s, 0);
+  }
+  assert(other);
+  for (uint c = 0; c < s->nb_cells; c++)
+    if (s->best[c] == V_BULB && g->squares[c] != S_LIGHTBULB) return c;
+  assert(false);  // a solution can't be a subset of another one
+  return NONE;
+}
+
+/* ************************************************************************** */
+
+/* move a random wall on square d, light bulbs are kept */
+static void _move_wall(game g, uint d, uint nb_walls, uint64_t* state) {
+  uint k = _rand_next(state) % nb_walls;
+  for (uint c = 0; c < g->nb_rows * g->nb_cols; c++)
+    if (g->squares[c] & S_BLACK)
+      g->squares[c] = (k-- == 0) ? S_BLANK : S_BLACKU;
+  g->squares[d] = S_BLACKU;
+}
+
+/* ************************************************************************** */
+
+game game_random_ext(uint nb_rows, uint nb_cols, bool wrapping, uint nb_walls,
+                     bool with_solution, uint64_t seed) {
+  uint size = nb_rows * nb_cols;
+  assert(nb_walls <= size);
+  uint* order = malloc((size + 1) * sizeof(uint));
+  assert(order);
+  uint64_t state = seed;
+
+  // random walls
+  game g = game_new_empty_ext(nb_rows, nb_cols, wrapping);
+  for (uint c = 0; c < size; c++) order[c] = c;
+  _shuffle(order, size, &state);
+  for (uint k = 0; k < nb_walls; k++) g->squares[order[k]] = S_BLACKU;
+
+  // random solution, walls are moved until it is unique
+  solver* s = NULL;
+  for (uint attempt = 0; !s && attempt < MAX_ATTEMPTS; attempt++) {
+    _random_solution(g, order, &state);
+    s = solver_new(g);
+    uint d = _other_solution(g, s);
+    if (d == NONE) break;
+    solver_delete(s);
+    s = NULL;
+    if (nb_walls == 0) break;
+    _move_wall(g, d, nb_walls, &state);
+  }
+
+  if (s) {
+    game_restart(g);  // keep walls only
+    for (uint w = 0; w < s->nb_walls; w++) order[w] = w;
+    _shuffle(order, s->nb_walls, &state);
+    _remove_clues(&s, 1, order, s->nb_walls);
+    for (uint w = 0; w < s->nb_walls; w++)
+      if (s->wall_num[w] < 0) g->squares[s->wall_cell[w]] = S_BLACKU;
+    solver_delete(s);
+  } else {
+    game_delete(g);
+    g = NULL;
+  }
+  free(order);
+  if (g && with_solution) game_solve(g);
+  if (g) _flags_compute(g);
+  return g;
+}
+
+/* ************************************************************************** */
+
+game game_random(uint nb_rows, uint nb_cols, bool wrapping, uint nb_walls,
+                 bool with_solution) {
+  uint64_t seed = ((uint64_t)rand() << 32) ^ (uint64_t)rand();
+  return game_random_ext(nb_rows, nb_cols, wrapping, nb_walls, with_solution,
+                         seed);
+}
+
+/* ************************************************************************** */
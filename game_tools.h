@@ -9,10 +9,109 @@
 #ifndef __GAME_TOOLS_H__
 #define __GAME_TOOLS_H__
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include "game.h"
 
+/**
+ * @brief Deduction rules that justify a hint.
+ **/
+typedef enum {
+  H_NONE = 0,    /**< no forced move (guessing is needed) */
+  H_WALL_FULL,   /**< a numbered wall already has all its light bulbs */
+  H_WALL_FREE,   /**< a numbered wall has just enough free neighbours */
+  H_SINGLE,      /**< an unlit square can only be lit from one square */
+  H_EXCLUSION    /**< a light bulb here would leave a square unlit or a wall
+                     unsatisfiable */
+} hint_rule;
+
+/**
+ * @brief A forced move and the rule that justifies it.
+ **/
+typedef struct {
+  uint i, j;      /**< square of the move */
+  square s;       /**< S_LIGHTBULB or S_MARK */
+  hint_rule rule; /**< rule that forces the move */
+  uint ri, rj;    /**< wall or square the rule applies to */
+} hint;
+
+/** number of rules in @ref hint_rule */
+#define NB_HINT_RULES (H_EXCLUSION + 1)
+
+/**
+ * @brief Difficulty report of a puzzle.
+ * @details Deduction proceeds in rounds: each round applies at once all the
+ * moves forced by the simplest rules on the current position, or else by
+ * @ref H_EXCLUSION. When deduction is stuck, the rest is solved by search.
+ **/
+typedef struct {
+  bool solvable;                /**< the puzzle has a solution */
+  bool unique;                  /**< the puzzle has a single solution */
+  uint nb_rounds;               /**< number of deduction rounds */
+  uint nb_moves[NB_HINT_RULES]; /**< number of moves forced by each rule */
+  hint_rule hardest;            /**< hardest rule used by deduction */
+  uint nb_guesses;              /**< number of guesses after deduction */
+  uint score;                   /**< overall difficulty score */
+} grade;
+
+/**
+ * @brief The 8 symmetries of a grid.
+ * @details Quarter turns and transpositions swap the number of rows and the
+ * number of columns of a rectangular game.
+ **/
+typedef enum {
+  T_IDENTITY = 0,  /**< unchanged */
+  T_ROTATE_90,     /**< quarter turn clockwise */
+  T_ROTATE_180,    /**< half turn */
+  T_ROTATE_270,    /**< quarter turn counterclockwise */
+  T_FLIP_H,        /**< left and right swapped */
+  T_FLIP_V,        /**< top and bottom swapped */
+  T_TRANSPOSE,     /**< rows and columns swapped */
+  T_ANTITRANSPOSE  /**< flipped along the other diagonal */
+} transform;
+
+/** number of transforms in @ref transform */
+#define NB_TRANSFORMS (T_ANTITRANSPOSE + 1)
+
+/**
+ * @brief Error codes of the file routines.
+ **/
+typedef enum {
+  GAME_OK = 0,     /**< success */
+  GAME_ERR_PARAM,  /**< invalid parameter */
+  GAME_ERR_IO,     /**< the file can't be opened, read or written */
+  GAME_ERR_FORMAT, /**< the content is not a valid game */
+  GAME_ERR_MEMORY  /**< memory allocation failed */
+} game_error;
+
+/**
+ * @brief A read-only pack of games, mapped in memory.
+ **/
+typedef struct game_pack_s* game_pack;
+
+/**
+ * @brief A reader of games stored one after the other in a stream.
+ **/
+typedef struct game_reader_s* game_reader;
+
+/**
+ * @brief A session file recording a game and its undo/redo history.
+ **/
+typedef struct game_session_s* game_session;
+
+/**
+ * @brief A replay of the moves of a game, mapped in memory.
+ **/
+typedef struct game_replay_s* game_replay;
+
+/**
+ * @brief A hint context, keeping the solver of a game from one hint to the
+ * next.
+ **/
+typedef struct game_hinter_s* game_hinter;
+
 /**
  * @name Game Tools
  * @{
@@ -22,10 +121,354 @@
  * @brief Creates a game by loading its description from a text file.
  * @details See the file format description in @ref index.
  * @param filename input file
- * @return the loaded game
+ * @return the loaded game, or NULL on error (a message is printed on stderr)
  **/
 game game_load(char* filename);
 
+/**
+ * @brief Creates a game by loading its description from a text file.
+ * @details Same as @ref game_load, but the cause of a failure is returned.
+ * Dimensions can have any number of digits, and each row may end with
+ * "\r\n". The file is read at once and parsed in a single pass.
+ * @param filename input file
+ * @param g where to store the loaded game (unchanged on error)
+ * @return GAME_OK, or the error met
+ **/
+game_error game_load_ext(const char* filename, game* g);
+
+/**
+ * @brief Creates a game from its text description in memory.
+ * @details The buffer holds the content of a file saved by @ref game_save,
+ * and doesn't need to be null-terminated. It is parsed in place.
+ * @param buf the text description
+ * @param len length of the text description
+ * @return the loaded game, or NULL if the description is not valid
+ **/
+game game_load_mem(const char* buf, size_t len);
+
+/**
+ * @brief Writes the text description of a game in memory.
+ * @details The text is the content of the file written by @ref game_save,
+ * followed by a null character. Like snprintf(), nothing is written if the
+ * buffer is too small, and the length needed is returned anyway.
+ * @param g the game
+ * @param buf the output buffer (may be NULL if @p cap is 0)
+ * @param cap size of the buffer
+ * @return the length of the text description, without the null character
+ **/
+size_t game_save_mem(cgame g, char* buf, size_t cap);
+
+/**
+ * @brief Encodes a game in the compact binary format.
+ * @details The format starts with an 18-byte header: the magic "LUPB", a
+ * version byte, a flags byte (bit 0: wrapping, bit 1: run-length encoding),
+ * the numbers of rows and columns (16 bits each), the payload size and a
+ * checksum of the header and payload (32 bits each), all in little-endian.
+ * The payload holds the square states (without flags), either packed two per
+ * byte, or as one byte per run of up to 16 equal squares (state in the high
+ * nibble, length minus one in the low nibble), whichever is smaller. Like
+ * snprintf(), nothing is written if the buffer is too small.
+ * @param g the game
+ * @param buf the output buffer (may be NULL if @p cap is 0)
+ * @param cap size of the buffer
+ * @pre the game has at most 65535 rows and 65535 columns
+ * @return the size of the encoded game
+ **/
+size_t game_encode(cgame g, uint8_t* buf, size_t cap);
+
+/**
+ * @brief Decodes a game from the compact binary format.
+ * @details Bytes after the encoded game are ignored.
+ * @param buf the encoded game
+ * @param len number of bytes available
+ * @return the decoded game, or NULL if the data is truncated, corrupted or
+ * of another version
+ **/
+game game_decode(const uint8_t* buf, size_t len);
+
+/**
+ * @brief Creates a game from a puzzle ID of Simon Tatham's collection.
+ * @details An ID reads "<cols>x<rows>:<desc>", where the description lists
+ * the squares in row-major order: a letter from 'a' to 'z' stands for a run
+ * of 1 to 26 blank squares, a digit from '0' to '4' for a numbered wall and
+ * 'B' for an unnumbered wall. As an extension, a 'w' after the dimensions
+ * ("7x7w:...") makes the game wrapping. The ID ends at @p len, or at the
+ * first space or end of line.
+ * @param id the puzzle ID (not necessarily null-terminated)
+ * @param len length of the ID
+ * @return the game, or NULL if the ID is not valid
+ **/
+game game_load_id(const char* id, size_t len);
+
+/**
+ * @brief Writes the puzzle ID of a game.
+ * @details See @ref game_load_id for the format. Only walls are kept, light
+ * bulbs and marks are written as blank squares. Like snprintf(), nothing is
+ * written if the buffer is too small.
+ * @param g the game
+ * @param buf the output buffer (may be NULL if @p cap is 0)
+ * @param cap size of the buffer
+ * @return the length of the ID, without the null character
+ **/
+size_t game_save_id(cgame g, char* buf, size_t cap);
+
+/**
+ * @brief Writes a pack of games.
+ * @details A pack file starts with a 12-byte header (the magic "LUPK", a
+ * version byte, three zero bytes and the number of games n on 32 bits),
+ * followed by n+1 offsets on 64 bits (the start of each game, then the end
+ * of the file) and by the games in the format of @ref game_encode, all in
+ * little-endian.
+ * @param filename output file
+ * @param games the games to write
+ * @param n number of games
+ * @return GAME_OK, or the error met
+ **/
+game_error game_pack_write(const char* filename, const cgame* games, uint n);
+
+/**
+ * @brief Opens a pack of games.
+ * @details The file is mapped in memory, and nothing but its header is read.
+ * @param filename input file
+ * @return the pack, or NULL if the file can't be mapped or is not a pack
+ **/
+game_pack game_pack_open(const char* filename);
+
+/**
+ * @brief Gets the number of games in a pack.
+ * @param pack the pack
+ * @return the number of games
+ **/
+uint game_pack_size(game_pack pack);
+
+/**
+ * @brief Creates the k-th game of a pack.
+ * @details Only this game is read, in constant time. The pack is not modified,
+ * so that several threads can get games from the same pack.
+ * @param pack the pack
+ * @param k the index of the game
+ * @pre @p k < game_pack_size(pack)
+ * @return the game, or NULL if its data is corrupted
+ **/
+game game_pack_get(game_pack pack, uint k);
+
+/**
+ * @brief Reads the k-th game of a pack into an existing game.
+ * @details Unlike @ref game_pack_get, nothing is allocated: the squares of
+ * @p g are overwritten (a view is made to own its grid first), its history is
+ * cleared and its flags are computed in place. A whole pack of games of the
+ * same size can be scanned this way with a single game, e.g. with
+ * game_is_over(). The solver routines (@ref game_solve,
+ * @ref game_nb_solutions, @ref game_hint...) still build their own solver on
+ * each call. @p g is unchanged on failure.
+ * @param pack the pack
+ * @param k the index of the game
+ * @param g the game, of the same size and wrapping option as the k-th game
+ * @pre @p k < game_pack_size(pack)
+ * @return true, or false if the k-th game has another size or wrapping
+ * option, or if its data is corrupted
+ **/
+bool game_pack_get_into(game_pack pack, uint k, game g);
+
+/**
+ * @brief Closes a pack of games.
+ * @details Games created by @ref game_pack_get remain valid.
+ * @param pack the pack (may be NULL)
+ **/
+void game_pack_close(game_pack pack);
+
+/**
+ * @brief Creates a reader of games from a stream.
+ * @details The stream holds games one after the other, possibly separated by
+ * empty lines, each one in the text format of @ref game_save, as a puzzle ID
+ * on a line (see @ref game_load_id) or in the binary format of
+ * @ref game_encode. The format is detected for each game. Games are read one
+ * at a time through a buffer that is reused, so the memory used depends on
+ * the size of the largest game, not on the size of the stream. A line longer
+ * than its game allows (a row longer than the number of columns, or a puzzle
+ * ID with more characters than squares) is a format error.
+ * @param f the input stream, left open by @ref game_reader_delete
+ * @return the reader, or NULL on error
+ **/
+game_reader game_reader_new(FILE* f);
+
+/**
+ * @brief Creates a reader of games from a file.
+ * @details See @ref game_reader_new.
+ * @param filename the input file, closed by @ref game_reader_delete
+ * @return the reader, or NULL if the file can't be opened
+ **/
+game_reader game_reader_open(const char* filename);
+
+/**
+ * @brief Reads the next game.
+ * @param r the reader
+ * @return the next game, or NULL at the end of the stream or on error (see
+ * @ref game_reader_error)
+ **/
+game game_reader_next(game_reader r);
+
+/**
+ * @brief Gets the error that stopped a reader.
+ * @param r the reader
+ * @return GAME_OK if no error occurred, or the first error met
+ **/
+game_error game_reader_error(game_reader r);
+
+/**
+ * @brief Deletes a reader.
+ * @details Games already read remain valid.
+ * @param r the reader (may be NULL)
+ **/
+void game_reader_delete(game_reader r);
+
+/**
+ * @brief Creates a session file for a game.
+ * @details The session stores the board before the first move of the
+ * history, the moves played (undone ones included) and the undo/redo cursor,
+ * so that @ref game_session_restore gives back the game with its history.
+ * The file is written in full here, then @ref game_session_sync only appends
+ * what changed since the last sync, at a cost proportional to the number of
+ * new moves. Only the moves, undo, redo and restart are recorded: squares set
+ * with game_set_square() are not. A game has at most one session at a time.
+ * A full write goes to "<filename>.tmp", forced to disk and renamed to
+ * @p filename, so that a crash leaves either the old file or the new one:
+ * a journal can be attached to the file it was just restored from.
+ * @param g the game, which must outlive the session
+ * @param filename the session file, replaced if it exists
+ * @return the session, or NULL on error
+ **/
+game_session game_session_create(game g, const char* filename);
+
+/**
+ * @brief Appends the changes of the history since the last sync.
+ * @details The changes are written with a single write and flushed, but not
+ * forced to disk. If the program stops during a sync, the file is restored
+ * as it was after the previous one. After a restart or a change of the whole
+ * board, the file is written in full instead, as by
+ * @ref game_session_create.
+ * @param s the session
+ * @return GAME_OK, or the error met
+ **/
+game_error game_session_sync(game_session s);
+
+/**
+ * @brief Closes a session file, without syncing it.
+ * @param s the session (may be NULL)
+ **/
+void game_session_close(game_session s);
+
+/**
+ * @brief Restores a game and its history from a session file.
+ * @param filename the session file
+ * @return the game, or NULL if the file can't be read or is not valid
+ **/
+game game_session_restore(const char* filename);
+
+/**
+ * @brief Attaches a journal to a game.
+ * @details The journal is a session file (see @ref game_session_create)
+ * synced after each move, undo, redo and restart of @p g, so that it can be
+ * replayed with @ref game_session_restore after a crash. To bound the cost of
+ * each move, the file is forced to disk by batches of 64 syncs, or once per
+ * second: a system crash may lose the last second of moves. The journal is
+ * detached by @ref game_journal_detach or game_delete().
+ * @param g the game
+ * @param filename the journal file, replaced if it exists
+ * @return GAME_OK, or the error met
+ **/
+game_error game_journal_attach(game g, const char* filename);
+
+/**
+ * @brief Forces the journal of a game to disk and detaches it.
+ * @param g the game
+ * @return GAME_OK, or the first error met while writing the journal
+ **/
+game_error game_journal_detach(game g);
+
+/**
+ * @brief Writes the moves played in a game to a replay file.
+ * @details The file holds the moves that lead to the current position (the
+ * undone ones are dropped), and a snapshot of the board every @p interval
+ * moves, so that any move can be reached quickly.
+ * @param filename the replay file
+ * @param g the game
+ * @param interval number of moves between two snapshots (K)
+ * @return GAME_OK, or the error met
+ **/
+game_error game_replay_write(const char* filename, cgame g, uint interval);
+
+/**
+ * @brief Opens a replay file, positioned before the first move.
+ * @details The file is mapped in memory. Moves are checked when they are
+ * played.
+ * @param filename the replay file
+ * @return the replay, or NULL if the file can't be read or is not valid
+ **/
+game_replay game_replay_open(const char* filename);
+
+/**
+ * @brief Gets the number of moves of a replay.
+ * @param r the replay
+ * @return the number of moves
+ **/
+uint game_replay_size(game_replay r);
+
+/**
+ * @brief Gets the current position of a replay.
+ * @param r the replay
+ * @return the number of moves played, from 0 to @ref game_replay_size
+ **/
+uint game_replay_position(game_replay r);
+
+/**
+ * @brief Gets the board at the current position of a replay.
+ * @details The flags are up to date. The game belongs to the replay: it is
+ * only valid until the next call on @p r.
+ * @param r the replay
+ * @return the board
+ **/
+cgame game_replay_game(game_replay r);
+
+/**
+ * @brief Plays the next move of a replay.
+ * @details The flags are updated around the move only.
+ * @param r the replay
+ * @return false at the end of the replay or if the move is not valid
+ **/
+bool game_replay_next(game_replay r);
+
+/**
+ * @brief Takes back the previous move of a replay.
+ * @details The flags are updated around the move only.
+ * @param r the replay
+ * @return false at the start of the replay or if the move is not valid
+ **/
+bool game_replay_prev(game_replay r);
+
+/**
+ * @brief Moves a replay to a given position.
+ * @details The board is reached from the nearest snapshot or from the current
+ * position, so that at most K moves are played.
+ * @param r the replay
+ * @param k the number of moves to play, from 0 to @ref game_replay_size
+ * @return false if @p k is out of range or the file is not valid
+ **/
+bool game_replay_seek(game_replay r, uint k);
+
+/**
+ * @brief Closes a replay.
+ * @param r the replay (may be NULL)
+ **/
+void game_replay_close(game_replay r);
+
+/**
+ * @brief Describes an error code.
+ * @param err the error code
+ * @return a static string
+ **/
+const char* game_strerror(game_error err);
+
 /**
  * @brief Saves a game in a text file.
  * @details See the file format description in @ref index.
@@ -34,6 +477,79 @@ game game_load(char* filename);
  **/
 void game_save(cgame g, char* filename);
 
+/**
+ * @brief Saves a game in a text file.
+ * @details Same as @ref game_save, but the cause of a failure is returned.
+ * The whole text is formatted in memory and written with a single call. If
+ * @p atomic is true, it is written to "<filename>.tmp", flushed to disk and
+ * renamed to @p filename, and the directory is flushed in turn, so that a
+ * crash or a power loss leaves either the old or the new file, never a
+ * truncated one. Flushing the directory is best effort: once the rename has
+ * succeeded, the save succeeds even if the directory can't be synced.
+ * @param g game to save
+ * @param filename output file
+ * @param atomic replace the file atomically
+ * @return GAME_OK, or the error met
+ **/
+game_error game_save_ext(cgame g, const char* filename, bool atomic);
+
+/**
+ * @brief Transforms a game by a symmetry of the grid.
+ * @details The squares, flags included, and the moves of the history are
+ * moved, so that undo and redo apply to the transformed game.
+ * @param g the game
+ * @param t the transform
+ **/
+void game_transform(game g, transform t);
+
+/**
+ * @brief Finds the transform that gives the canonical image of a game.
+ * @details Among the 8 images of @p g by @ref transform, the canonical image
+ * is the one with the fewest rows, then the smallest states (flags ignored)
+ * in row-major order. All images of a game have the same canonical image.
+ * The candidates are compared in a single pass over the squares and dropped
+ * as soon as they differ from the smallest one.
+ * @param g the game
+ * @return the transform that gives the canonical image (the first one if
+ * several give it)
+ **/
+transform game_canonical_transform(cgame g);
+
+/**
+ * @brief Hashes the canonical image of a game.
+ * @details Games that are rotations or reflections of each other have the
+ * same hash: it is meant as the key of deduplication sets and solution
+ * caches. The light bulbs and marks are hashed as well as the walls.
+ * @param g the game
+ * @return a 64-bit hash
+ **/
+uint64_t game_canonical_hash(cgame g);
+
+/**
+ * @brief Opens a cache of solutions, used by the solver of the process.
+ * @details Once opened, @ref game_solve and @ref game_nb_solutions look for
+ * the puzzle in the cache before solving it, and store their result in it.
+ * Puzzles are keyed by @ref game_canonical_hash of their walls, so that a
+ * rotation or a reflection of a cached puzzle is found too. The cache is a
+ * file of fixed size mapped in memory and shared by all the processes that
+ * open it: readers never wait, and writers are serialized by a file lock.
+ * A key is looked for in 16 slots from its home slot on: when they are all
+ * taken by other keys, the entry in the home slot is evicted, whatever its
+ * age. Games of more than 384 squares are not cached. The file is in the byte
+ * order of the machine. This function and @ref game_cache_close must not be
+ * called while other threads are solving.
+ * @param filename the cache file, created if it doesn't exist
+ * @param nb_slots number of solutions kept in a new file (rounded up to a
+ * power of 2), ignored if the file exists
+ * @return GAME_OK, or the error met
+ **/
+game_error game_cache_open(const char* filename, uint nb_slots);
+
+/**
+ * @brief Closes the cache of solutions of the process, if any.
+ **/
+void game_cache_close(void);
+
 /**
  * @brief Computes the solution of a given game
  * @param g the game to solve
@@ -51,6 +567,122 @@ bool game_solve(game g);
  */
 uint game_nb_solutions(game g);
 
+/**
+ * @brief Computes a solution starting from the current position of a game.
+ * @details Unlike @ref game_solve, the light bulbs and marks already played
+ * are kept as assumptions (a mark meaning "not a light"). If the position can
+ * be completed, @p g is updated with this solution. Otherwise @p g is
+ * unchanged and a minimal set of conflicting squares is returned: removing
+ * any one of them makes the remaining moves consistent again. No square is
+ * returned if the puzzle has no solution at all.
+ * @param g the game to solve
+ * @param conflicts an array of at least nb_rows*nb_cols entries, where the
+ * conflicting squares are stored as row-major indices (i*nb_cols+j), or NULL
+ * @param nb_conflicts address where to store the number of conflicting
+ * squares, or NULL
+ * @return true if a solution is found, false otherwise
+ */
+bool game_solve_from_position(game g, uint* conflicts, uint* nb_conflicts);
+
+/**
+ * @brief Finds the next forced move from the current position of a game.
+ * @details The light bulbs and marks already played are taken for granted,
+ * and the simplest rule that forces a light bulb or a mark on a blank unlit
+ * square is looked for, in this order: @ref H_WALL_FULL, @ref H_WALL_FREE,
+ * @ref H_SINGLE and @ref H_EXCLUSION.
+ * @param g the game
+ * @param h address where to store the hint
+ * @return true if a forced move is found, false if none exists or if the
+ * position already has a mistake
+ */
+bool game_hint(cgame g, hint* h);
+
+/**
+ * @brief Creates a hint context.
+ * @details The context keeps the segment structure of the last game it was
+ * asked about and the moves it has assumed, so that a hint only replays the
+ * moves changed since the previous one instead of rebuilding the solver.
+ * Changing a wall, or asking about a game of another size, rebuilds it.
+ * @return the context
+ **/
+game_hinter game_hinter_new(void);
+
+/**
+ * @brief Finds the next forced move from the current position of a game.
+ * @details Same as @ref game_hint, using the solver kept by @p hc. The
+ * squares are compared with those of the previous call, the removed moves
+ * being undone from the trail back to the oldest of them and the new ones
+ * assumed on top of it.
+ * @param hc the hint context
+ * @param g the game
+ * @param h address where to store the hint
+ * @return true if a forced move is found, false if none exists or if the
+ * position already has a mistake
+ **/
+bool game_hinter_next(game_hinter hc, cgame g, hint* h);
+
+/**
+ * @brief Deletes a hint context.
+ * @param hc the hint context (may be NULL)
+ **/
+void game_hinter_delete(game_hinter hc);
+
+/**
+ * @brief Grades the difficulty of a puzzle.
+ * @details Only the walls of @p g are considered, the moves already played
+ * are ignored. The score sums the moves forced by each rule, weighted by the
+ * rule difficulty (1 for walls, 2 for single candidates, 4 for exclusion),
+ * plus 10 per guess. This function does not use any global state and can be
+ * run concurrently on different games.
+ * @param g the game
+ * @return the difficulty report
+ */
+grade game_grade(cgame g);
+
+/**
+ * @brief Removes the wall numbers that are not needed for a unique solution.
+ * @details The numbers are tried from the weakest (the one with the most ways
+ * to put its light bulbs) to the strongest, and a wall becomes unnumbered
+ * (S_BLACKU) as long as the solution stays unique. Trials are run in
+ * parallel on @p nb_threads threads, with the same result as a single one.
+ * The game is left unchanged if it doesn't have a unique solution.
+ * @param g the game
+ * @param nb_threads number of threads to use (0 or 1 for no thread)
+ * @pre @p g must be a valid pointer toward a game structure.
+ * @return the number of wall numbers removed
+ **/
+uint game_minimize_clues(game g, uint nb_threads);
+
+/**
+ * @brief Creates a random game with a unique solution.
+ * @details Walls are placed at random, a random layout of light bulbs that
+ * lights the whole grid is chosen, and all walls are numbered accordingly.
+ * While another solution exists, a wall is moved on a square where it differs
+ * from this layout. Numbers are then removed one by one in random order as
+ * long as the solution stays unique. The random seed is taken from rand().
+ * @param nb_rows number of rows in game
+ * @param nb_cols number of columns in game
+ * @param wrapping wrapping option
+ * @param nb_walls number of walls to place
+ * @param with_solution if true, the game contains the solution, otherwise
+ * only walls
+ * @pre @p nb_walls <= nb_rows*nb_cols
+ * @return the created game, or NULL if no game with a unique solution was
+ * found (for instance with too few walls)
+ **/
+game game_random(uint nb_rows, uint nb_cols, bool wrapping, uint nb_walls,
+                 bool with_solution);
+
+/**
+ * @brief Creates a random game with a unique solution from a given seed.
+ * @details Same as @ref game_random, except that the same seed always gives
+ * the same game, and that no global state is used (this function can be run
+ * concurrently).
+ * @param seed the random seed
+ **/
+game game_random_ext(uint nb_rows, uint nb_cols, bool wrapping, uint nb_walls,
+                     bool with_solution, uint64_t seed);
+
 /**
  * @}
  */
@@ -6,10 +6,12 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "game.h"
 #include "game_aux.h"
 #include "game_ext.h"
+#include "game_fast.h"
 #include "game_private.h"
 #include "game_tools.h"
 #include "queue.h"
@@ -34,6 +36,13 @@ struct Env_t {
   SDL_Surface *surfaceMessage4;
   SDL_Surface *surfaceMessageErreur;
   game g;
+  bool *mistakes; /* cases en conflit trouvées par la vérification */
+  int hint;       /* case conseillée par l'indice, -1 sinon */
+  game_hinter hinter; /* solveur gardé d'un indice au suivant */
+  SDL_Texture *board; /* cases dessinées, seules les cases changées sont
+                         repeintes d'une image à l'autre */
+  int board_w, board_h;
+  bool repaint; /* toutes les cases sont à repeindre */
   float grille_x, grille_y;
 };
 
@@ -45,12 +54,30 @@ Env *init(SDL_Window *fenetre, SDL_Renderer *ren, int argc, char *argv[]) {
   int w, h;
   SDL_GetWindowSize(fenetre, &w, &h);
 
-  /* récupération du jeu */
-  if (argc == 2) {
+  /* récupération du jeu, ou reprise depuis le journal (-j <journal>) */
+  char *journal = NULL;
+  if (argc >= 3 && strcmp(argv[1], "-j") == 0) {
+    journal = argv[2];
+    argc -= 2;
+    argv += 2;
+  }
+  if (journal && (env->g = game_session_restore(journal))) {
+    printf("game restored from %s\n", journal);
+  } else if (argc == 2) {
     (env->g) = game_load(argv[1]);
+    if (!env->g) ERROR("game_load: %s\n", argv[1]);
   } else {
     env->g = game_default();
   }
+  if (journal && game_journal_attach(env->g, journal) != GAME_OK)
+    ERROR("game_journal_attach: %s\n", journal);
+  env->mistakes =
+      calloc(game_nb_rows(env->g) * game_nb_cols(env->g), sizeof(bool));
+  if (!env->mistakes) ERROR("calloc: mistakes\n");
+  env->hint = -1;
+  env->hinter = game_hinter_new();
+  env->board = NULL;
+  env->repaint = true;
   // Chargement de toutes les textures de la structure.
   env->background = IMG_LoadTexture(ren, BACKGROUND);
   if (!env->background) ERROR("IMG_LoadTexture: %s\n", BACKGROUND);
@@ -109,13 +136,85 @@ void TraceGrille(SDL_Renderer *ren, Env *env, int w, int h) {
   }
 }
 
+// Dessine la case (i,j) dans le rectangle rect.
+static void PoserCase(SDL_Renderer *ren, Env *env, SDL_Rect rect, uint i,
+                      uint j) {
+  // EFFACE LA CASE, LE FOND RESTE VISIBLE SOUS LES CASES NON COLORIÉES
+  SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_NONE);
+  SDL_SetRenderDrawColor(ren, 0, 0, 0, 0);
+  SDL_RenderFillRect(ren, &rect);
+  SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
+
+  // POSE DES CASE NOIR
+  if (game_fast_is_black(env->g, i, j)) {
+    int number = game_fast_black_number(env->g, i, j);
+    SDL_SetRenderDrawColor(ren, 0, 0, 0, 255);
+    SDL_RenderFillRect(ren, &rect);
+    // create a rect content the black number
+    SDL_Rect Message_rect;
+    Message_rect.y = rect.y + (0.2 * rect.w);
+    Message_rect.x = rect.x + (0.1 * rect.h);
+    Message_rect.w = rect.w * 0.8;
+    Message_rect.h = rect.h * 0.8;
+    // Pose de la surface correspondant au bon chiffre dans les cases
+    // blacks.
+    SDL_Surface *messages[] = {env->surfaceMessage0, env->surfaceMessage1,
+                               env->surfaceMessage2, env->surfaceMessage3,
+                               env->surfaceMessage4};
+    if (number >= 0 && number <= 4) {
+      SDL_Texture *Message =
+          SDL_CreateTextureFromSurface(ren, messages[number]);
+      SDL_RenderCopy(ren, Message, NULL, &Message_rect);
+      SDL_DestroyTexture(Message);
+    }
+  }
+  // POSE DES BLANK
+  if (game_fast_is_blank(env->g, i, j)) {
+    SDL_SetRenderDrawColor(ren, 169, 169, 169, 255);
+    SDL_RenderFillRect(ren, &rect);
+  }
+  // POSE DES LIGHT
+  if (game_fast_is_lighted(env->g, i, j)) {
+    SDL_SetRenderDrawColor(ren, 255, 255, 0, 255);
+    SDL_RenderFillRect(ren, &rect);
+  }
+  // POSE DES LIGHTBULB
+  if (game_fast_is_lightbulb(env->g, i, j)) {
+    SDL_SetRenderDrawColor(ren, 255, 255, 255, 255);
+    SDL_RenderFillRect(ren, &rect);
+  }
+  // POSE DES LIGHTBULB
+  if (game_fast_has_error(env->g, i, j)) {
+    SDL_SetRenderDrawColor(ren, 255, 0, 0, 255);
+    SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_MOD);
+    SDL_RenderFillRect(ren, &rect);
+    SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
+  }
+  // POSE DES ERREURS DU JOUEUR
+  if (env->mistakes[i * game_nb_cols(env->g) + j]) {
+    SDL_Rect inner = {rect.x + 2, rect.y + 2, rect.w - 4, rect.h - 4};
+    SDL_SetRenderDrawColor(ren, 255, 128, 0, 255);
+    SDL_RenderDrawRect(ren, &rect);
+    SDL_RenderDrawRect(ren, &inner);
+  }
+  // POSE DE L'INDICE
+  if (env->hint == (int)(i * game_nb_cols(env->g) + j)) {
+    SDL_Rect inner = {rect.x + 2, rect.y + 2, rect.w - 4, rect.h - 4};
+    SDL_SetRenderDrawColor(ren, 0, 200, 0, 255);
+    SDL_RenderDrawRect(ren, &rect);
+    SDL_RenderDrawRect(ren, &inner);
+  }
+}
+
+/* **************************************************************** */
+
+// Repeint les cases changées depuis l'image précédente, ou toutes les cases.
 void PlacerCase(SDL_Renderer *ren, Env *env, int w, int h) {
   SDL_Rect rect;
   float marge = 0.15 * w;
   float cote = fmin(w, h) - marge;
   uint colonne = game_nb_cols(env->g);
   uint ligne = game_nb_rows(env->g);
-  int number;
   float x_grille = cote - marge;
   float y_grille = cote - marge;
   uint case_x = x_grille / colonne;
@@ -129,78 +228,70 @@ void PlacerCase(SDL_Renderer *ren, Env *env, int w, int h) {
   for (uint i = 0; i < ligne + 1; i++) {
     tab_y[i] = marge + (i * case_y);
   }
-  // BOUCLE SUR TOUTE LA GRILLE
-  for (uint i = 0; i < colonne; i++) {
-    for (uint j = 0; j < ligne; j++) {
-      rect.y = tab_x[i];
-      rect.x = tab_y[j];
-      rect.w = tab_x[i + 1] - tab_x[i];
-      rect.h = tab_y[j + 1] - tab_y[j];
-
-      // POSE DES CASE NOIR
-      if (game_is_black(env->g, i, j)) {
-        number = game_get_black_number(env->g, i, j);
-        SDL_SetRenderDrawColor(ren, 0, 0, 0, 255);
-        SDL_RenderFillRect(ren, &rect);
-        // create a rect content the black number
-        SDL_Rect Message_rect;
-        Message_rect.y = tab_x[i] + (0.2 * rect.w);
-        Message_rect.x = tab_y[j] + (0.1 * rect.h);
-        Message_rect.w = rect.w * 0.8;
-        Message_rect.h = rect.h * 0.8;
-        // Pose de la surface correspondant au bon chiffre dans les cases
-        // blacks.
-        if (number == 0) {
-          SDL_Texture *Message =
-              SDL_CreateTextureFromSurface(ren, env->surfaceMessage0);
-          SDL_RenderCopy(ren, Message, NULL, &Message_rect);
-          SDL_DestroyTexture(Message);
-        } else if (number == 1) {
-          SDL_Texture *Message =
-              SDL_CreateTextureFromSurface(ren, env->surfaceMessage1);
-          SDL_RenderCopy(ren, Message, NULL, &Message_rect);
-          SDL_DestroyTexture(Message);
-        } else if (number == 2) {
-          SDL_Texture *Message =
-              SDL_CreateTextureFromSurface(ren, env->surfaceMessage2);
-          SDL_RenderCopy(ren, Message, NULL, &Message_rect);
-          SDL_DestroyTexture(Message);
-        } else if (number == 3) {
-          SDL_Texture *Message =
-              SDL_CreateTextureFromSurface(ren, env->surfaceMessage3);
-          SDL_RenderCopy(ren, Message, NULL, &Message_rect);
-          SDL_DestroyTexture(Message);
-        } else if (number == 4) {
-          SDL_Texture *Message =
-              SDL_CreateTextureFromSurface(ren, env->surfaceMessage4);
-          SDL_RenderCopy(ren, Message, NULL, &Message_rect);
-          SDL_DestroyTexture(Message);
-        }
-      }
-      // POSE DES BLANK
-      if (game_is_blank(env->g, i, j)) {
-        SDL_SetRenderDrawColor(ren, 169, 169, 169, 255);
-        SDL_RenderFillRect(ren, &rect);
-      }
-      // POSE DES LIGHT
-      if (game_is_lighted(env->g, i, j)) {
-        SDL_SetRenderDrawColor(ren, 255, 255, 0, 255);
-        SDL_RenderFillRect(ren, &rect);
-      }
-      // POSE DES LIGHTBULB
-      if (game_is_lightbulb(env->g, i, j)) {
-        SDL_SetRenderDrawColor(ren, 255, 255, 255, 255);
-        SDL_RenderFillRect(ren, &rect);
-      }
-      // POSE DES LIGHTBULB
-      if (game_has_error(env->g, i, j)) {
-        SDL_SetRenderDrawColor(ren, 255, 0, 0, 255);
-        SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_MOD);
-        SDL_RenderFillRect(ren, &rect);
-        SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
-      }
-    }
+  // LISTE DES CASES À REPEINDRE
+  uint size = ligne * colonne;
+  uint cells[size];
+  uint nb = size;
+  if (env->repaint)
+    for (uint k = 0; k < size; k++) cells[k] = k;
+  else
+    nb = game_changed_cells(env->g, cells, size);
+  for (uint k = 0; k < nb; k++) {
+    uint i = cells[k] / colonne, j = cells[k] % colonne;
+    rect.x = tab_x[j];
+    rect.y = tab_y[i];
+    rect.w = tab_x[j + 1] - tab_x[j];
+    rect.h = tab_y[i + 1] - tab_y[i];
+    PoserCase(ren, env, rect, i, j);
   }
+  game_ack_changes(env->g);
+  env->repaint = false;
+}
+
+/* **************************************************************** */
+
+// Efface les erreurs et l'indice affichés (après chaque coup).
+void ClearMistakes(Env *env) {
+  uint size = game_nb_rows(env->g) * game_nb_cols(env->g);
+  if (env->hint >= 0) env->repaint = true;
+  for (uint k = 0; k < size; k++) {
+    if (env->mistakes[k]) env->repaint = true;
+    env->mistakes[k] = false;
+  }
+  env->hint = -1;
+}
+
+/* **************************************************************** */
+
+// Cherche le prochain coup forcé et l'encadre en vert.
+void ShowHint(Env *env) {
+  hint h;
+  ClearMistakes(env);
+  if (!game_hinter_next(env->hinter, env->g, &h)) {
+    PRINT("pas d'indice\n");
+    return;
+  }
+  env->hint = h.i * game_nb_cols(env->g) + h.j;
+  env->repaint = true;
+  PRINT("indice : %s en (%u,%u)\n",
+        h.s == S_LIGHTBULB ? "ampoule" : "marque", h.i, h.j);
+}
+
+/* **************************************************************** */
+
+// Vérifie la position du joueur et marque les coups en conflit.
+void CheckMistakes(Env *env) {
+  uint size = game_nb_rows(env->g) * game_nb_cols(env->g);
+  uint *conflicts = malloc(size * sizeof(uint));
+  if (!conflicts) ERROR("malloc: conflicts\n");
+  uint nb = 0;
+  game copy = game_copy(env->g);  // la position du joueur reste intacte
+  game_solve_from_position(copy, conflicts, &nb);
+  ClearMistakes(env);
+  for (uint k = 0; k < nb; k++) env->mistakes[conflicts[k]] = true;
+  env->repaint = true;
+  game_delete(copy);
+  free(conflicts);
 }
 
 void PlacerLight(SDL_Window *win, SDL_Renderer *ren, Env *env, int mouse_x,
@@ -248,7 +339,25 @@ void render(SDL_Window *win, SDL_Renderer *ren, Env *env) {
   int w, h;
   SDL_GetWindowSize(win, &w, &h);
   SDL_RenderCopy(ren, env->background, NULL, NULL); /* put the background */
+  // les cases restent dessinées dans une texture de la taille de la fenêtre
+  if (!env->board || env->board_w != w || env->board_h != h) {
+    if (env->board) SDL_DestroyTexture(env->board);
+    env->board = SDL_CreateTexture(ren, SDL_PIXELFORMAT_RGBA8888,
+                                   SDL_TEXTUREACCESS_TARGET, w, h);
+    if (!env->board) ERROR("SDL_CreateTexture: %s\n", SDL_GetError());
+    SDL_SetTextureBlendMode(env->board, SDL_BLENDMODE_BLEND);
+    env->board_w = w;
+    env->board_h = h;
+    env->repaint = true;
+  }
+  SDL_SetRenderTarget(ren, env->board);
+  if (env->repaint) {
+    SDL_SetRenderDrawColor(ren, 0, 0, 0, 0);
+    SDL_RenderClear(ren);
+  }
   PlacerCase(ren, env, w, h);
+  SDL_SetRenderTarget(ren, NULL);
+  SDL_RenderCopy(ren, env->board, NULL, NULL);
   TraceGrille(ren, env, w, h);
 }
 
@@ -259,16 +368,21 @@ bool process(SDL_Window *win, SDL_Renderer *ren, Env *env, SDL_Event *e) {
   SDL_GetWindowSize(win, &w, &h);
   if (e->type == SDL_QUIT) {
     return true;
+    // Texture des cases perdue par le renderer.
+  } else if (e->type == SDL_RENDER_TARGETS_RESET) {
+    env->repaint = true;
     // Intéraction à la souris.
   } else if (e->type == SDL_MOUSEBUTTONDOWN) {
     SDL_Point mouse;
     SDL_GetMouseState(&mouse.x, &mouse.y);
     PlacerLight(win, ren, env, mouse.x, mouse.y);
+    ClearMistakes(env);
     if (game_is_over(env->g)) {
       printf("WIN !!\n");
     }
     // Option complémentaires...
   } else if (e->type == SDL_KEYDOWN) {
+    ClearMistakes(env);
     switch (e->key.keysym.sym) {
       // Restart
       case SDLK_r:
@@ -292,6 +406,18 @@ bool process(SDL_Window *win, SDL_Renderer *ren, Env *env, SDL_Event *e) {
           game_solve(env->g);
         }
         break;
+      // Check
+      case SDLK_c:
+        if (!game_is_over(env->g)) {
+          CheckMistakes(env);
+        }
+        break;
+      // Hint
+      case SDLK_h:
+        if (!game_is_over(env->g)) {
+          ShowHint(env);
+        }
+        break;
       // Quit
       case SDLK_q:
         return true;
@@ -307,6 +433,10 @@ bool process(SDL_Window *win, SDL_Renderer *ren, Env *env, SDL_Event *e) {
 void clean(SDL_Window *win, SDL_Renderer *ren, Env *env) {
   /* PUT YOUR CODE HERE TO CLEAN MEMORY */
 
+  if (env->board) SDL_DestroyTexture(env->board);
+  game_delete(env->g);  // also forces the journal to disk
+  game_hinter_delete(env->hinter);
+  free(env->mistakes);
   free(env);
 }
 
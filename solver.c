@@ -0,0 +1,464 @@
+/**
+ * @file solver.c
+ * @copyright University of Bordeaux. All rights reserved, 2021.
+ **/
+
+#include "solver.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game.h"
+#include "game_ext.h"
+#include "game_fast.h"
+#include "game_private.h"
+
+/* ************************************************************************** */
+/*                                INTERNAL                                    */
+/* ************************************************************************** */
+
+/* split a row or a column into segments, wrapping around the first wall */
+static void _add_line(solver *s, const uint *line, uint len, uint d,
+                      const bool *black, uint *fill) {
+  uint start = 0;
+  if (s->wrapping) {
+    for (uint k = 0; k < len; k++)
+      if (black[line[k]]) {
+        start = k + 1;
+        break;
+      }
+  }
+  bool open = false;
+  for (uint k = 0; k < len; k++) {
+    uint c = line[(start + k) % len];
+    if (black[c]) {
+      open = false;
+      continue;
+    }
+    if (!open) {
+      s->seg_first[s->nb_segs++] = *fill;
+      open = true;
+    }
+    s->seg[d][c] = s->nb_segs - 1;
+    s->seg_cells[(*fill)++] = c;
+  }
+}
+
+/* ************************************************************************** */
+
+static void _assign(solver *s, uint c, value v, rule r, uint id) {
+  assert(s->val[c] == V_UNKNOWN);
+  s->val[c] = v;
+  s->why[c] = r;
+  s->why_id[c] = id;
+  s->pos[c] = s->trail_len;
+  s->trail[s->trail_len++] = c;
+  for (uint d = 0; d < 2; d++) {
+    uint seg = s->seg[d][c];
+    s->seg_free[seg]--;
+    if (v == V_BULB) s->seg_bulbs[seg]++;
+  }
+  for (uint k = s->cell_wall_first[c]; k < s->cell_wall_first[c + 1]; k++) {
+    uint w = s->cell_walls[k];
+    s->wall_free[w]--;
+    if (v == V_BULB) s->wall_bulbs[w]++;
+  }
+}
+
+/* ************************************************************************** */
+
+static void _unassign(solver *s, uint c) {
+  value v = s->val[c];
+  for (uint d = 0; d < 2; d++) {
+    uint seg = s->seg[d][c];
+    s->seg_free[seg]++;
+    if (v == V_BULB) s->seg_bulbs[seg]--;
+  }
+  for (uint k = s->cell_wall_first[c]; k < s->cell_wall_first[c + 1]; k++) {
+    uint w = s->cell_walls[k];
+    s->wall_free[w]++;
+    if (v == V_BULB) s->wall_bulbs[w]--;
+  }
+  s->val[c] = V_UNKNOWN;
+  s->why[c] = R_NONE;
+  s->assumed[c] = false;
+}
+
+/* ************************************************************************** */
+
+static bool _conflict(solver *s, rule r, uint id, uint c) {
+  s->confl_rule = r;
+  s->confl_id = id;
+  s->confl_cell = c;
+  return false;
+}
+
+/* ************************************************************************** */
+
+static bool _imply(solver *s, uint c, value v, rule r, uint id) {
+  if (s->val[c] == v) return true;
+  if (s->val[c] != V_UNKNOWN) return _conflict(s, r, id, c);
+  _assign(s, c, v, r, id);
+  return true;
+}
+
+/* ************************************************************************** */
+
+/* an unlit square needs at least one candidate left in its segments */
+static bool _check_cover(solver *s, uint x) {
+  if (solver_is_lit(s, x)) return true;
+  uint n = solver_nb_candidates(s, x);
+  if (n == 0) return _conflict(s, R_SINGLE, x, NONE);
+  if (n > 1 || !(s->rules & RULE(R_SINGLE))) return true;
+  for (uint d = 0; d < 2; d++) {
+    uint seg = s->seg[d][x];
+    for (uint k = s->seg_first[seg]; k < s->seg_first[seg + 1]; k++) {
+      uint y = s->seg_cells[k];
+      if (s->val[y] == V_UNKNOWN) return _imply(s, y, V_BULB, R_SINGLE, x);
+    }
+  }
+  return true;
+}
+
+/* ************************************************************************** */
+
+/* a numbered wall needs exactly its number of light bulbs around it */
+static bool _check_wall(solver *s, uint w) {
+  int k = s->wall_num[w];
+  if (k < 0) return true;
+  int b = s->wall_bulbs[w];
+  int f = s->wall_free[w];
+  if (b > k || b + f < k) return _conflict(s, R_WALL_FULL, w, NONE);
+  if (f == 0) return true;
+  if (b != k && b + f != k) return true;
+  value v = (b == k) ? V_EMPTY : V_BULB;
+  rule r = (b == k) ? R_WALL_FULL : R_WALL_FREE;
+  if (!(s->rules & RULE(r))) return true;
+  for (uint d = 0; d < 4; d++) {
+    uint y = s->wall_neigh[4 * w + d];
+    if (y == NONE || s->val[y] != V_UNKNOWN) continue;
+    if (!_imply(s, y, v, r, w)) return false;
+  }
+  return true;
+}
+
+/* ************************************************************************** */
+
+static bool _check_all(solver *s) {
+  for (uint w = 0; w < s->nb_walls; w++)
+    if (!_check_wall(s, w)) return false;
+  for (uint c = 0; c < s->nb_cells; c++)
+    if (s->wall_of[c] == NONE && !_check_cover(s, c)) return false;
+  return true;
+}
+
+/* ************************************************************************** */
+
+/* mark the squares assigned before trail position 'before' that a rule uses */
+static void _mark_scope(solver *s, rule r, uint id, uint before) {
+  if (r == R_SEGMENT) {
+    for (uint k = s->seg_first[id]; k < s->seg_first[id + 1]; k++) {
+      uint y = s->seg_cells[k];
+      if (s->val[y] == V_BULB && s->pos[y] < before) s->seen[y] = 1;
+    }
+  } else if (r == R_WALL_FULL || r == R_WALL_FREE) {
+    for (uint d = 0; d < 4; d++) {
+      uint y = s->wall_neigh[4 * id + d];
+      if (y != NONE && s->val[y] != V_UNKNOWN && s->pos[y] < before)
+        s->seen[y] = 1;
+    }
+  } else if (r == R_SINGLE) {
+    for (uint d = 0; d < 2; d++) {
+      uint seg = s->seg[d][id];
+      for (uint k = s->seg_first[seg]; k < s->seg_first[seg + 1]; k++) {
+        uint y = s->seg_cells[k];
+        if (s->val[y] != V_UNKNOWN && s->pos[y] < before) s->seen[y] = 1;
+      }
+    }
+  }
+}
+
+/* ************************************************************************** */
+
+static void _search(solver *s, uint limit, uint *count) {
+  s->nb_nodes++;
+  if (!solver_propagate(s)) return;
+
+  // branch on the unlit square with the fewest candidates
+  uint best = NONE, best_n = 0;
+  for (uint c = 0; c < s->nb_cells; c++) {
+    if (s->wall_of[c] != NONE || solver_is_lit(s, c)) continue;
+    uint n = solver_nb_candidates(s, c);
+    if (best == NONE || n < best_n) {
+      best = c;
+      best_n = n;
+      if (n <= 2) break;
+    }
+  }
+
+  // all squares are lit: this is a solution
+  if (best == NONE) {
+    if (*count == 0) memcpy(s->best, s->val, s->nb_cells);
+    (*count)++;
+    return;
+  }
+
+  uint y = NONE;
+  for (uint d = 0; d < 2 && y == NONE; d++) {
+    uint seg = s->seg[d][best];
+    for (uint k = s->seg_first[seg]; k < s->seg_first[seg + 1]; k++)
+      if (s->val[s->seg_cells[k]] == V_UNKNOWN) {
+        y = s->seg_cells[k];
+        break;
+      }
+  }
+  assert(y != NONE);
+
+  uint mark = s->trail_len;
+  _assign(s, y, V_BULB, R_NONE, NONE);
+  _search(s, limit, count);
+  solver_undo(s, mark);
+  if (*count >= limit) return;
+  _assign(s, y, V_EMPTY, R_NONE, NONE);
+  _search(s, limit, count);
+  solver_undo(s, mark);
+}
+
+/* ************************************************************************** */
+/*                             SOLVER ROUTINES                                */
+/* ************************************************************************** */
+
+solver *solver_new(cgame g) {
+  assert(g);
+  solver *s = calloc(1, sizeof(solver));
+  assert(s);
+  uint nb_rows = game_nb_rows(g);
+  uint nb_cols = game_nb_cols(g);
+  uint n = nb_rows * nb_cols;
+  s->nb_rows = nb_rows;
+  s->nb_cols = nb_cols;
+  s->nb_cells = n;
+  s->wrapping = game_is_wrapping(g);
+
+  bool *black = malloc(n * sizeof(bool));
+  uint *line = malloc(MAX(nb_rows, nb_cols) * sizeof(uint));
+  s->seg[0] = malloc(n * sizeof(uint));
+  s->seg[1] = malloc(n * sizeof(uint));
+  s->seg_first = malloc((2 * n + 1) * sizeof(uint));
+  s->seg_cells = malloc(2 * n * sizeof(uint));
+  s->wall_of = malloc(n * sizeof(uint));
+  assert(black && line && s->seg[0] && s->seg[1]);
+  assert(s->seg_first && s->seg_cells && s->wall_of);
+
+  for (uint c = 0; c < n; c++) {
+    black[c] = game_fast_is_black(g, c / nb_cols, c % nb_cols);
+    s->seg[0][c] = s->seg[1][c] = NONE;
+    s->wall_of[c] = NONE;
+    if (black[c]) s->wall_of[c] = s->nb_walls++;
+  }
+
+  // segments
+  uint fill = 0;
+  for (uint i = 0; i < nb_rows; i++) {
+    for (uint j = 0; j < nb_cols; j++) line[j] = i * nb_cols + j;
+    _add_line(s, line, nb_cols, 0, black, &fill);
+  }
+  for (uint j = 0; j < nb_cols; j++) {
+    for (uint i = 0; i < nb_rows; i++) line[i] = i * nb_cols + j;
+    _add_line(s, line, nb_rows, 1, black, &fill);
+  }
+  s->seg_first[s->nb_segs] = fill;
+
+  // walls and their neighbours
+  uint nw = s->nb_walls;
+  s->wall_cell = malloc((nw + 1) * sizeof(uint));
+  s->wall_num = malloc((nw + 1) * sizeof(int));
+  s->wall_neigh = malloc((4 * nw + 1) * sizeof(uint));
+  s->cell_wall_first = calloc(n + 1, sizeof(uint));
+  s->cell_walls = malloc((4 * nw + 1) * sizeof(uint));
+  assert(s->wall_cell && s->wall_num && s->wall_neigh);
+  assert(s->cell_wall_first && s->cell_walls);
+  direction dirs[] = {UP, DOWN, LEFT, RIGHT};
+  for (uint c = 0; c < n; c++) {
+    uint w = s->wall_of[c];
+    if (w == NONE) continue;
+    uint i = c / nb_cols, j = c % nb_cols;
+    s->wall_cell[w] = c;
+    s->wall_num[w] = game_fast_black_number(g, i, j);
+    for (uint d = 0; d < 4; d++) {
+      int ii = i, jj = j;
+      uint y = NONE;
+      if (_next(g, &ii, &jj, dirs[d]) && !black[ii * nb_cols + jj])
+        y = ii * nb_cols + jj;
+      s->wall_neigh[4 * w + d] = y;
+      if (y != NONE) s->cell_wall_first[y + 1]++;
+    }
+  }
+  for (uint c = 0; c < n; c++)
+    s->cell_wall_first[c + 1] += s->cell_wall_first[c];
+  uint *next = malloc((n + 1) * sizeof(uint));
+  assert(next);
+  memcpy(next, s->cell_wall_first, (n + 1) * sizeof(uint));
+  for (uint w = 0; w < nw; w++)
+    for (uint d = 0; d < 4; d++) {
+      uint y = s->wall_neigh[4 * w + d];
+      if (y != NONE) s->cell_walls[next[y]++] = w;
+    }
+  free(next);
+  free(line);
+  free(black);
+
+  // dynamic state
+  s->val = malloc(n + 1);
+  s->why = calloc(n + 1, 1);
+  s->why_id = malloc((n + 1) * sizeof(uint));
+  s->pos = malloc((n + 1) * sizeof(uint));
+  s->assumed = calloc(n + 1, sizeof(bool));
+  s->trail = malloc((n + 1) * sizeof(uint));
+  s->seg_bulbs = calloc(s->nb_segs + 1, sizeof(uint));
+  s->seg_free = malloc((s->nb_segs + 1) * sizeof(uint));
+  s->wall_bulbs = calloc(nw + 1, sizeof(int));
+  s->wall_free = calloc(nw + 1, sizeof(int));
+  s->best = malloc(n + 1);
+  s->seen = malloc(n + 1);
+  assert(s->val && s->why && s->why_id && s->pos && s->assumed && s->trail);
+  assert(s->seg_bulbs && s->seg_free && s->wall_bulbs && s->wall_free);
+  assert(s->best && s->seen);
+  for (uint c = 0; c < n; c++)
+    s->val[c] = (s->wall_of[c] == NONE) ? V_UNKNOWN : V_EMPTY;
+  for (uint seg = 0; seg < s->nb_segs; seg++)
+    s->seg_free[seg] = s->seg_first[seg + 1] - s->seg_first[seg];
+  for (uint w = 0; w < nw; w++)
+    for (uint d = 0; d < 4; d++)
+      if (s->wall_neigh[4 * w + d] != NONE) s->wall_free[w]++;
+  memcpy(s->best, s->val, n);
+  s->confl_cell = NONE;
+  s->rules = RULES_ALL;
+  return s;
+}
+
+/* ************************************************************************** */
+
+void solver_delete(solver *s) {
+  if (!s) return;
+  free(s->seg[0]);
+  free(s->seg[1]);
+  free(s->seg_first);
+  free(s->seg_cells);
+  free(s->wall_cell);
+  free(s->wall_num);
+  free(s->wall_neigh);
+  free(s->cell_wall_first);
+  free(s->cell_walls);
+  free(s->wall_of);
+  free(s->val);
+  free(s->why);
+  free(s->why_id);
+  free(s->pos);
+  free(s->assumed);
+  free(s->trail);
+  free(s->seg_bulbs);
+  free(s->seg_free);
+  free(s->wall_bulbs);
+  free(s->wall_free);
+  free(s->best);
+  free(s->seen);
+  free(s);
+}
+
+/* ************************************************************************** */
+
+void solver_set_wall(solver *s, uint w, int num) {
+  assert(s && w < s->nb_walls);
+  assert(num >= -1 && num <= 4);
+  assert(s->trail_len == 0);
+  s->wall_num[w] = num;
+}
+
+/* ************************************************************************** */
+
+void solver_undo(solver *s, uint mark) {
+  assert(s);
+  while (s->trail_len > mark) _unassign(s, s->trail[--s->trail_len]);
+  if (s->qhead > mark) s->qhead = mark;
+}
+
+/* ************************************************************************** */
+
+bool solver_assume(solver *s, uint c, value v) {
+  assert(s && c < s->nb_cells);
+  assert(s->wall_of[c] == NONE);
+  if (s->val[c] == v) return true;
+  if (s->val[c] != V_UNKNOWN) return _conflict(s, R_NONE, NONE, c);
+  _assign(s, c, v, R_NONE, NONE);
+  s->assumed[c] = true;
+  return true;
+}
+
+/* ************************************************************************** */
+
+bool solver_propagate(solver *s) {
+  assert(s);
+  if (s->qhead == 0 && !_check_all(s)) return false;
+  while (s->qhead < s->trail_len) {
+    uint c = s->trail[s->qhead++];
+    for (uint d = 0; d < 2; d++) {
+      uint seg = s->seg[d][c];
+      if (s->val[c] == V_BULB) {
+        // a light bulb empties its segments
+        if (s->seg_bulbs[seg] > 1) return _conflict(s, R_SEGMENT, seg, NONE);
+        for (uint k = s->seg_first[seg]; k < s->seg_first[seg + 1]; k++) {
+          uint y = s->seg_cells[k];
+          if (s->val[y] == V_UNKNOWN) _assign(s, y, V_EMPTY, R_SEGMENT, seg);
+        }
+      } else if (s->seg_bulbs[seg] == 0) {
+        // an empty square is one candidate less for unlit squares
+        for (uint k = s->seg_first[seg]; k < s->seg_first[seg + 1]; k++)
+          if (!_check_cover(s, s->seg_cells[k])) return false;
+      }
+    }
+    for (uint k = s->cell_wall_first[c]; k < s->cell_wall_first[c + 1]; k++)
+      if (!_check_wall(s, s->cell_walls[k])) return false;
+  }
+  return true;
+}
+
+/* ************************************************************************** */
+
+uint solver_search(solver *s, uint limit) {
+  assert(s);
+  uint count = 0;
+  uint mark = s->trail_len;
+  if (limit > 0) _search(s, limit, &count);
+  solver_undo(s, mark);
+  return count;
+}
+
+/* ************************************************************************** */
+
+uint solver_explain(solver *s, uint *core) {
+  assert(s && core);
+  uint n = 0;
+  memset(s->seen, 0, s->nb_cells);
+  if (s->confl_rule == R_NONE) {
+    // an assumption clashes with the value of an assigned square
+    core[n++] = s->confl_cell;
+    s->seen[s->confl_cell] = 1;
+  } else {
+    _mark_scope(s, s->confl_rule, s->confl_id, s->trail_len);
+    if (s->confl_cell != NONE) s->seen[s->confl_cell] = 1;
+  }
+  for (uint k = s->trail_len; k-- > 0;) {
+    uint c = s->trail[k];
+    if (!s->seen[c]) continue;
+    if (s->assumed[c])
+      core[n++] = c;
+    else if (s->why[c] != R_NONE)
+      _mark_scope(s, s->why[c], s->why_id[c], k);
+  }
+  return n;
+}
+
+/* ************************************************************************** */
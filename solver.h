@@ -0,0 +1,168 @@
+/**
+ * @file solver.h
+ * @brief Private Solver Routines.
+ * @details The solver works on a static view of the grid made of
+ * *segments* (maximal runs of non-black squares in a row or a column, that
+ * wrap around on toric grids) and of wall constraints. Each non-black square
+ * is a boolean variable (light bulb or not), with three kinds of constraints:
+ * at most one light bulb per segment, at least one light bulb in the two
+ * segments crossing at each square, and an exact number of light bulbs around
+ * each numbered wall. Assignments are recorded on a trail, so that they can be
+ * undone in reverse order, and each implied value keeps the rule that forced
+ * it.
+ * @copyright University of Bordeaux. All rights reserved, 2021.
+ **/
+
+#ifndef __SOLVER_H__
+#define __SOLVER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "game.h"
+
+/* ************************************************************************** */
+/*                                CONSTANTS                                   */
+/* ************************************************************************** */
+
+/** no square index */
+#define NONE ((uint)-1)
+
+/** value of a square variable */
+typedef enum {
+  V_UNKNOWN = 0, /**< not yet decided */
+  V_BULB = 1,    /**< a light bulb */
+  V_EMPTY = 2    /**< no light bulb */
+} value;
+
+/** rule that justifies the value of a square */
+typedef enum {
+  R_NONE = 0,  /**< decision or assumption */
+  R_SEGMENT,   /**< a light bulb already sees this square */
+  R_WALL_FULL, /**< the wall has all its light bulbs */
+  R_WALL_FREE, /**< the wall has just enough free neighbours */
+  R_SINGLE     /**< an unlit square with a single candidate */
+} rule;
+
+/** bit of a rule in the mask of rules applied by propagation */
+#define RULE(r) (1u << (r))
+
+/** all the rules */
+#define RULES_ALL (RULE(R_WALL_FULL) | RULE(R_WALL_FREE) | RULE(R_SINGLE))
+
+/* ************************************************************************** */
+/*                             DATA TYPES                                     */
+/* ************************************************************************** */
+
+/**
+ * @brief Solver structure.
+ * @details The static part is built once from the walls of a game, the
+ * dynamic part is restored by @ref solver_undo.
+ */
+struct solver_s {
+  uint nb_rows;  /**< number of rows */
+  uint nb_cols;  /**< number of columns */
+  uint nb_cells; /**< number of squares */
+  bool wrapping; /**< the wrapping option */
+
+  /* segments */
+  uint *seg[2];    /**< horizontal and vertical segment of each square */
+  uint nb_segs;    /**< number of segments */
+  uint *seg_first; /**< first entry of each segment in seg_cells */
+  uint *seg_cells; /**< squares of all segments */
+
+  /* walls */
+  uint nb_walls;         /**< number of black walls */
+  uint *wall_cell;       /**< square index of each wall */
+  int *wall_num;         /**< expected number of light bulbs, -1 if none */
+  uint *wall_neigh;      /**< 4 non-black neighbours per wall, NONE if none */
+  uint *cell_wall_first; /**< first entry of each square in cell_walls */
+  uint *cell_walls;      /**< walls around each square (with multiplicity) */
+  uint *wall_of;         /**< wall index of each square, NONE if not black */
+
+  /* dynamic state */
+  uint rules;       /**< rules applied by propagation (segments always are) */
+  uint8_t *val;     /**< value of each square */
+  uint8_t *why;     /**< rule that forced each square */
+  uint *why_id;     /**< segment, wall or square used by the rule */
+  uint *pos;        /**< position of each square on the trail */
+  bool *assumed;    /**< square set as an assumption */
+  uint *trail;      /**< assigned squares, in order */
+  uint trail_len;   /**< number of assigned squares */
+  uint qhead;       /**< next square of the trail to propagate */
+  uint *seg_bulbs;  /**< number of light bulbs in each segment */
+  uint *seg_free;   /**< number of unknown squares in each segment */
+  int *wall_bulbs;  /**< number of light bulbs around each wall */
+  int *wall_free;   /**< number of unknown squares around each wall */
+  uint8_t *best;    /**< value of each square in the first solution found */
+  uint8_t *seen;    /**< scratch marks used by conflict analysis */
+
+  /* last conflict */
+  rule confl_rule; /**< rule violated */
+  uint confl_id;   /**< segment, wall or square of the violated rule */
+  uint confl_cell; /**< square whose value clashed, NONE if none */
+
+  /* statistics */
+  unsigned long nb_nodes; /**< number of search nodes */
+};
+
+typedef struct solver_s solver;
+
+/* ************************************************************************** */
+/*                             SOLVER ROUTINES                                */
+/* ************************************************************************** */
+
+/** create a solver from the walls of a game, with all squares unknown */
+solver *solver_new(cgame g);
+
+/** delete a solver */
+void solver_delete(solver *s);
+
+/**
+ * @brief change the number of light bulbs expected around a wall
+ * @details This adds (num >= 0) or removes (num = -1) the wall constraint
+ * without rebuilding the solver. It must be called with an empty trail.
+ */
+void solver_set_wall(solver *s, uint w, int num);
+
+/** undo all assignments back to a given trail length */
+void solver_undo(solver *s, uint mark);
+
+/** assign a square as an assumption, return false on conflict */
+bool solver_assume(solver *s, uint c, value v);
+
+/**
+ * @brief propagate pending assignments to a fixpoint
+ * @details Only the rules enabled in the rules mask imply new values, but
+ * the violation of any rule is reported as a conflict.
+ * @return false on conflict
+ */
+bool solver_propagate(solver *s);
+
+/**
+ * @brief count solutions from the current (propagated) state
+ * @details The search stops as soon as @p limit solutions are found, the
+ * first one being stored in best. The state is restored on return.
+ */
+uint solver_search(solver *s, uint limit);
+
+/**
+ * @brief explain the last conflict
+ * @details Stores in @p core the assumed squares responsible for the last
+ * conflict found by @ref solver_propagate or @ref solver_assume.
+ * @return the number of squares stored
+ */
+uint solver_explain(solver *s, uint *core);
+
+/** test if a non-black square is lit (a light bulb in one of its segments) */
+static inline bool solver_is_lit(const solver *s, uint c) {
+  return s->seg_bulbs[s->seg[0][c]] + s->seg_bulbs[s->seg[1][c]] > 0;
+}
+
+/** number of squares that can still light a given square */
+static inline uint solver_nb_candidates(const solver *s, uint c) {
+  uint n = s->seg_free[s->seg[0][c]] + s->seg_free[s->seg[1][c]];
+  return s->val[c] == V_UNKNOWN ? n - 1 : n;
+}
+
+#endif  // __SOLVER_H__
@@ -1,4 +1,25 @@
-Module.onRuntimeInitialized = () => { start(0,1); }
+// exports of game.js used by the demo: game.js and game.wasm are built by
+// "make" in this directory, and an older build lacks some of them
+const REQUIRED_EXPORTS = ['_changed_cells', '_ack_changes', '_export_squares',
+                          'HEAPU8', 'HEAPU32'];
+
+function hasExport(name) {
+    try {
+        return Module[name] !== undefined;
+    } catch (e) {  // a missing runtime method may throw when accessed
+        return false;
+    }
+}
+
+Module.onRuntimeInitialized = () => {
+    var missing = REQUIRED_EXPORTS.filter(name => !hasExport(name));
+    if (missing.length > 0) {
+        console.error("game.js is out of date (missing " + missing.join(", ") +
+                      "): rebuild it with make in the web directory");
+        return;
+    }
+    start(0,1);
+}
 
 // Demo Canvas (JavaScript)
 
@@ -6,6 +27,11 @@ Module.onRuntimeInitialized = () => { start(0,1); }
 
 var canvas = document.getElementById('mycanvas');
 const LIGHTBULB = 1;
+const MARK = 2;
+const BLACK = 8;
+const S_MASK = 0x0F;
+const F_LIGHTED = 16;
+const F_ERROR = 32;
 
 canvas.addEventListener('click', canvasLeftClick);        // left click event
 
@@ -20,70 +46,82 @@ function canvasLeftClick(event) {
 }
 /*************************************************************/
 
+// paint the square (row,col) of raw value s (see game_export_squares)
+function printSquare(ctx,row,col,s,p) {
+    var x = row+1;
+    var y = col+1;
+    var state = s & S_MASK;
+    var blank = (state == 0);
+    var black = (state & BLACK) != 0;
+    var ligthed = (s & F_LIGHTED) != 0;
+    var lightbulb = (state == LIGHTBULB);
+    var marked = (state == MARK);
+    var error = (s & F_ERROR) != 0;
+    ctx.clearRect(p*(x-1), p*(y-1), p, p);
+    if (black){
+        ctx.save();
+        ctx.fillStyle = 'black';
+        ctx.fillRect(p*(x-1), p*(y-1), p, p);
+        ctx.restore();
+        var b_val = state - BLACK;
+        if (b_val==0 || b_val==1 || b_val==2 || b_val==3 || b_val==4){
+            ctx.save();
+            ctx.font = 'bold 50px Arial';
+            ctx.fillStyle = 'white';
+            ctx.fillText(b_val, ((x-1)*(p))+15, ((y-0.20)*(p)));
+            ctx.restore();}
+    }
+    if (blank){
+        ctx.save();
+        ctx.fillStyle = 'lightgray';
+        ctx.fillRect(p*(x-1), p*(y-1), p, p);
+        ctx.restore();}
+    if (ligthed){
+        ctx.save();
+        ctx.fillStyle = 'yellow';
+        ctx.fillRect(p*(x-1), p*(y-1), p, p);
+        ctx.restore();}
+    if (lightbulb){
+        ctx.save();
+        ctx.fillStyle = 'white';
+        ctx.beginPath();
+        ctx.arc(p*(x-1)+p/2, p*(y-1)+p/2, p/3, 0,2*Math.PI);
+        ctx.closePath();
+        ctx.fill();
+        ctx.stroke();
+        ctx.restore();}
+    if (error){
+        ctx.save();
+        ctx.fillStyle = 'rgba(255,0,0,0.8)';
+        ctx.fillRect(p*(x-1), p*(y-1), p, p);
+        ctx.restore();}
+    if (marked){
+        ctx.save();
+        ctx.fillStyle = 'black';
+        ctx.fillRect((p*(x-1))+0.5*p, p*(y-1)+0.5*p, p/4, p);
+        ctx.restore();}
+}
+
+// repaint only the squares changed since the last call (all of them for a
+// new game)
 function printGame(g,ctx) {
-    var text = "";
     var nb_rows = Module._nb_rows(g);
     var nb_cols = Module._nb_cols(g);
     var w = canvas.width;
-    var h = canvas.height;
     var p = w/7;
-    var x=0;
-    for (var row = 0; row < nb_rows; row++) {
-        x+=1;
-        y=0;
-        for (var col = 0; col < nb_cols; col++) {
-            y+=1;
-            var blank = Module._is_blank(g, row, col);
-            var black = Module._is_black(g, row, col);
-            var ligthed = Module._is_lighted(g, row, col);
-            var lightbulb = Module._is_lightbulb(g, row, col);
-            var marked = Module._is_marked(g, row, col);
-            var error = Module._has_error(g, row, col);
-            if (black){
-                ctx.save();
-                ctx.fillStyle = 'black';
-                ctx.fillRect(p*(x-1), p*(y-1), p, p);
-                ctx.restore();
-                var b_val = Module._get_black_number(g,row,col);
-                if (b_val==0 || b_val==1 || b_val==2 || b_val==3 || b_val==4){
-                    ctx.save();
-                    ctx.font = 'bold 50px Arial';
-                    ctx.fillStyle = 'white';
-                    ctx.fillText(b_val, ((x-1)*(p))+15, ((y-0.20)*(p)));
-                    ctx.restore();}
-            }
-            if (blank){
-                ctx.save();
-                ctx.fillStyle = 'lightgray';
-                ctx.fillRect(p*(x-1), p*(y-1), p, p);
-                ctx.restore();}
-            if (ligthed){
-                ctx.save();
-                ctx.fillStyle = 'yellow';
-                ctx.fillRect(p*(x-1), p*(y-1), p, p);
-                ctx.restore();}
-            if (lightbulb){
-                ctx.save();
-                ctx.fillStyle = 'white';
-                ctx.beginPath();
-                ctx.arc(p*(x-1)+p/2, p*(y-1)+p/2, p/3, 0,2*Math.PI);
-                ctx.closePath();
-                ctx.fill();
-                ctx.stroke();
-                ctx.restore();}
-            if (error){
-                ctx.save();
-                ctx.fillStyle = 'rgba(255,0,0,0.8)';
-                ctx.fillRect(p*(x-1), p*(y-1), p, p);
-                ctx.restore();}
-            if (marked){
-                ctx.save();
-                ctx.fillStyle = 'black';
-                ctx.fillRect((p*(x-1))+0.5*p, p*(y-1)+0.5*p, p/4, p);
-                ctx.restore();}
-        }
-        text += "\n";
+    var size = nb_rows * nb_cols;
+    var cells = Module._malloc(4 * size);
+    var squares = Module._malloc(size);
+    var nb = Module._changed_cells(g, cells, size);
+    Module._export_squares(g, squares);  // the whole board in a single call
+    var board = Module.HEAPU8.subarray(squares, squares + size);
+    for (var k = 0; k < nb; k++) {
+        var c = Module.HEAPU32[(cells >> 2) + k];
+        printSquare(ctx, Math.floor(c / nb_cols), c % nb_cols, board[c], p);
     }
+    Module._ack_changes(g);
+    Module._free(squares);
+    Module._free(cells);
     drawLine (ctx,canvas.height,canvas.width);
 }
 
@@ -161,9 +199,7 @@ function drawCanvas(x,y) {
     var width = canvas.width;
     var height = canvas.height;
 
-    // clear canvas
-    ctx.clearRect(0, 0, width, height);
-
+    // the canvas is kept: printGame() repaints the changed squares only
     drawLine(ctx,height,width);
     play_mouv(g,ctx);
     if (x!= undefined && y!= undefined){
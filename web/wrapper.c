@@ -7,13 +7,14 @@
 
 #include <emscripten.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <time.h>
 
 #include "game.h"
 #include "game_aux.h"
 #include "game_ext.h"
-// #include "game_tools.h"
+#include "game_tools.h"
 
 /* ******************** Game V1 & V2 API ******************** */
 
@@ -71,25 +72,55 @@ bool is_lighted(cgame g, uint i, uint j) { return game_is_lighted(g, i, j); }
 EMSCRIPTEN_KEEPALIVE
 bool has_error(cgame g, uint i, uint j) { return game_has_error(g, i, j); }
 
+/* ******************** Game Ext API ******************** */
+
+EMSCRIPTEN_KEEPALIVE
+uint changed_cells(cgame g, uint *cells, uint cap) { return game_changed_cells(g, cells, cap); }
+
+EMSCRIPTEN_KEEPALIVE
+void ack_changes(game g) { game_ack_changes(g); }
+
+/* the squares are copied into a heap buffer, read by JS as a Uint8Array */
+
+EMSCRIPTEN_KEEPALIVE
+void export_squares(cgame g, uint8_t *out) { game_export_squares(g, out); }
+
+EMSCRIPTEN_KEEPALIVE
+void export_rows(cgame g, uint first, uint nb, uint8_t *out) { game_export_rows(g, first, nb, out); }
+
 /* ******************** Game Tools API ******************** */
 
-// EMSCRIPTEN_KEEPALIVE
-// bool solve(game g) { return game_solve(g); }
+EMSCRIPTEN_KEEPALIVE
+bool solve(game g) { return game_solve(g); }
+
+EMSCRIPTEN_KEEPALIVE
+uint nb_solutions(game g) { return game_nb_solutions(g); }
+
+EMSCRIPTEN_KEEPALIVE
+void undo(game g) { game_undo(g); }
+
+EMSCRIPTEN_KEEPALIVE
+void redo(game g) { game_redo(g); }
+
+EMSCRIPTEN_KEEPALIVE
+game new_random(uint nb_rows, uint nb_cols, bool wrapping, uint nb_walls, bool with_solution)
+{
+  srand(time(NULL)); // radom seed
+  return game_random(nb_rows, nb_cols, wrapping, nb_walls, with_solution);
+}
+
+/* the text buffer is given by JS (a string or a heap pointer), no file system involved */
 
-// EMSCRIPTEN_KEEPALIVE
-// uint nb_solutions(cgame g) { return game_nb_solutions(g); }
+EMSCRIPTEN_KEEPALIVE
+game load(const char *buf, size_t len) { return game_load_mem(buf, len); }
 
-// EMSCRIPTEN_KEEPALIVE
-// void undo(game g) { game_undo(g); }
+EMSCRIPTEN_KEEPALIVE
+size_t save(cgame g, char *buf, size_t cap) { return game_save_mem(g, buf, cap); }
 
-// EMSCRIPTEN_KEEPALIVE
-// void redo(game g) { game_redo(g); }
+EMSCRIPTEN_KEEPALIVE
+game load_id(const char *id, size_t len) { return game_load_id(id, len); }
 
-// EMSCRIPTEN_KEEPALIVE
-// game new_random(uint nb_rows, uint nb_cols, bool wrapping, uint nb_walls, bool with_solution)
-// {
-//   srand(time(NULL)); // radom seed
-//   return game_random(nb_rows, nb_cols, wrapping, nb_walls, with_solution);
-// }
+EMSCRIPTEN_KEEPALIVE
+size_t save_id(cgame g, char *buf, size_t cap) { return game_save_id(g, buf, cap); }
 
 // EOF